@@ -199,12 +199,19 @@ int WINAPI wWinMain( HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmdL
     {
         CDXUTComboBox *comboBox = gSampleUI.GetComboBox(IDC_PROFILE);
         comboBox->AddItem(L"BC4 (R)", (void*)(CompressImageBC4));
+        comboBox->AddItem(L"BC4 (R) slow", (void*)(CompressImageBC4_slow));
         comboBox->AddItem(L"BC5 (RG)", (void*)(CompressImageBC5));
+        comboBox->AddItem(L"BC5 (RG) slow", (void*)(CompressImageBC5_slow));
         comboBox->AddItem(L"BC6H veryfast", (void *)(CompressImageBC6H_veryfast));
         comboBox->AddItem(L"BC6H fast", (void *)(CompressImageBC6H_fast));
         comboBox->AddItem(L"BC6H basic", (void *)(CompressImageBC6H_basic));
         comboBox->AddItem(L"BC6H slow", (void *)(CompressImageBC6H_slow));
         comboBox->AddItem(L"BC6H veryslow", (void *)(CompressImageBC6H_veryslow));
+        comboBox->AddItem(L"BC6H signed veryfast", (void *)(CompressImageBC6H_signed_veryfast));
+        comboBox->AddItem(L"BC6H signed fast", (void *)(CompressImageBC6H_signed_fast));
+        comboBox->AddItem(L"BC6H signed basic", (void *)(CompressImageBC6H_signed_basic));
+        comboBox->AddItem(L"BC6H signed slow", (void *)(CompressImageBC6H_signed_slow));
+        comboBox->AddItem(L"BC6H signed veryslow", (void *)(CompressImageBC6H_signed_veryslow));
         comboBox->AddItem(L"BC7 ultrafast (RGB)", (void *)(CompressImageBC7_ultrafast));
         comboBox->AddItem(L"BC7 veryfast (RGB)", (void *)(CompressImageBC7_veryfast));
         comboBox->AddItem(L"BC7 fast (RGB)", (void *)(CompressImageBC7_fast));
@@ -260,7 +267,12 @@ void InitApp()
 
     {
         CDXUTComboBox *comboBox = gSampleUI.GetComboBox(IDC_PROFILE);
+        comboBox->AddItem(L"BC1 ultrafast (RGB)", (void *)(CompressImageBC1_ultrafast));
+        comboBox->AddItem(L"BC1 veryfast (RGB)", (void *)(CompressImageBC1_veryfast));
+        comboBox->AddItem(L"BC1 fast (RGB)", (void *)(CompressImageBC1_fast));
         comboBox->AddItem(L"BC1 (RGB)", (void *)(CompressImageBC1));
+        comboBox->AddItem(L"BC1 slow (RGB)", (void *)(CompressImageBC1_slow));
+        comboBox->AddItem(L"BC1A (RGB, 1-bit alpha)", (void *)(CompressImageBC1A));
         comboBox->AddItem(L"BC3 (RGBA)", (void *)(CompressImageBC3));
         // Other options only added after D3D device created if DX11 available
     }
@@ -405,18 +405,12 @@ HRESULT CompressTexture(ID3D11ShaderResourceView* uncompressedSRV, ID3D11ShaderR
         input.stride = isBC4 ? uncompTexDesc.Width : (isBC5 ? (uncompTexDesc.Width * 2) : uncompData.RowPitch);
         input.width = uncompTexDesc.Width;
         input.height = uncompTexDesc.Height;
+        input.dst_stride = compData.RowPitch;
 
         BYTE* output = (BYTE*)compData.pData;
 
-        // Compress the uncompressed texels.
+        // Compress the uncompressed texels straight into the mapped DX layout.
         CompressImage(&input, output);
-
-        // remap for DX (expanding inplace, bottom-up)
-        int output_stride = (input.width/4)*GetBytesPerBlock(gCompressionFunc);
-        for (int y=input.height/4-1; y>=0; y--)
-        {
-            memmove(output+y*compData.RowPitch, output+y*output_stride, output_stride);
-        }
     }
 
     // Update the compression time.
@@ -489,7 +483,7 @@ HRESULT ComputeError(ID3D11ShaderResourceView* uncompressedSRV, ID3D11ShaderReso
     // Create a 2D resource without gamma correction for the two textures.
     if (IsBC6H(gCompressionFunc))
     {
-        compTexDesc.Format = DXGI_FORMAT_BC6H_UF16;
+        compTexDesc.Format = GetFormatFromCompressionFunc(gCompressionFunc);
         uncompTexDesc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
     }
     else
@@ -1047,6 +1041,7 @@ VOID CompressImageMT(const rgba_surface* input, BYTE* output)
 {
     const int numThreads = gNumWinThreads;
     const int bytesPerBlock = GetBytesPerBlock(gCompressionFunc);
+    const int outputPitch = input->dst_stride > 0 ? input->dst_stride : (input->width + 3) / 4 * bytesPerBlock;
 
     // We want to split the data evenly among all threads.
     const int linesPerThread = (input->height + numThreads - 1) / numThreads;
@@ -1067,7 +1062,7 @@ VOID CompressImageMT(const rgba_surface* input, BYTE* output)
         data->input = *input;
         data->input.ptr = input->ptr + y_start * input->stride;
         data->input.height = y_end-y_start;
-        data->output = output + (y_start/4) * (input->width/4) * bytesPerBlock;
+        data->output = output + (y_start/4) * outputPitch;
         data->cmpFunc = gCompressionFunc;
         data->state = eThreadState_DataLoaded;
         data->threadIdx = threadIdx;
@@ -1125,18 +1120,30 @@ int GetBytesPerBlock(CompressionFunc* fn)
         case DXGI_FORMAT_BC5_UNORM:
         case DXGI_FORMAT_BC7_UNORM_SRGB:
         case DXGI_FORMAT_BC6H_UF16:
+        case DXGI_FORMAT_BC6H_SF16:
             return 16;
     }
 }
 
+bool IsBC1(CompressionFunc* fn)
+{
+    return
+        fn == CompressImageBC1 ||
+        fn == CompressImageBC1_ultrafast ||
+        fn == CompressImageBC1_veryfast ||
+        fn == CompressImageBC1_fast ||
+        fn == CompressImageBC1_slow ||
+        fn == CompressImageBC1A;
+}
+
 bool IsBC4(CompressionFunc* fn)
 {
-    return fn == CompressImageBC4;
+    return fn == CompressImageBC4 || fn == CompressImageBC4_slow;
 }
 
 bool IsBC5(CompressionFunc* fn)
 {
-    return fn == CompressImageBC5;
+    return fn == CompressImageBC5 || fn == CompressImageBC5_slow;
 }
 
 bool IsBC6H(CompressionFunc* fn)
@@ -1146,16 +1153,28 @@ bool IsBC6H(CompressionFunc* fn)
         fn == CompressImageBC6H_fast ||
         fn == CompressImageBC6H_basic ||
         fn == CompressImageBC6H_slow ||
-        fn == CompressImageBC6H_veryslow;
+        fn == CompressImageBC6H_veryslow ||
+        IsBC6H_signed(fn);
+}
+
+bool IsBC6H_signed(CompressionFunc* fn)
+{
+    return
+        fn == CompressImageBC6H_signed_veryfast ||
+        fn == CompressImageBC6H_signed_fast ||
+        fn == CompressImageBC6H_signed_basic ||
+        fn == CompressImageBC6H_signed_slow ||
+        fn == CompressImageBC6H_signed_veryslow;
 }
 
 DXGI_FORMAT GetFormatFromCompressionFunc(CompressionFunc* fn)
 {
-    if (fn == CompressImageBC1) return DXGI_FORMAT_BC1_UNORM_SRGB;
+    if (IsBC1(fn)) return DXGI_FORMAT_BC1_UNORM_SRGB;
     if (fn == CompressImageBC3) return DXGI_FORMAT_BC3_UNORM_SRGB;
-    if (fn == CompressImageBC4) return DXGI_FORMAT_BC4_UNORM;
-    if (fn == CompressImageBC5) return DXGI_FORMAT_BC5_UNORM;
+    if (IsBC4(fn)) return DXGI_FORMAT_BC4_UNORM;
+    if (IsBC5(fn)) return DXGI_FORMAT_BC5_UNORM;
 
+    if (IsBC6H_signed(fn)) return DXGI_FORMAT_BC6H_SF16;
     if (IsBC6H(fn)) return DXGI_FORMAT_BC6H_UF16;
 
     return DXGI_FORMAT_BC7_UNORM_SRGB;
@@ -1181,6 +1200,41 @@ void CompressImageBC5(const rgba_surface* input, BYTE* output)
     CompressBlocksBC5(input, output);
 }
 
+void CompressImageBC4_slow(const rgba_surface* input, BYTE* output)
+{
+    bc4_enc_settings settings;
+    GetProfile_bc4_slow(&settings);
+    CompressBlocksBC4_settings(input, output, &settings);
+}
+
+void CompressImageBC5_slow(const rgba_surface* input, BYTE* output)
+{
+    bc4_enc_settings settings;
+    GetProfile_bc4_slow(&settings);
+    CompressBlocksBC5_settings(input, output, &settings);
+}
+
+#define DECLARE_CompressImageBC1_profile(profile)                               \
+void CompressImageBC1_ ## profile(const rgba_surface* input, BYTE* output)      \
+{                                                                               \
+    bc1_enc_settings settings;                                                  \
+    GetProfile_bc1_ ## profile(&settings);                                      \
+    CompressBlocksBC1_settings(input, output, &settings);                       \
+}
+
+DECLARE_CompressImageBC1_profile(ultrafast);
+DECLARE_CompressImageBC1_profile(veryfast);
+DECLARE_CompressImageBC1_profile(fast);
+DECLARE_CompressImageBC1_profile(slow);
+
+void CompressImageBC1A(const rgba_surface* input, BYTE* output)
+{
+    bc1_enc_settings settings;
+    GetProfile_bc1_basic(&settings);
+    settings.alpha_threshold = 128;
+    CompressBlocksBC1_settings(input, output, &settings);
+}
+
 #define DECLARE_CompressImageBC6H_profile(profile)                              \
 void CompressImageBC6H_ ## profile(const rgba_surface* input, BYTE* output)     \
 {                                                                               \
@@ -1194,6 +1248,11 @@ DECLARE_CompressImageBC6H_profile(fast);
 DECLARE_CompressImageBC6H_profile(basic);
 DECLARE_CompressImageBC6H_profile(slow);
 DECLARE_CompressImageBC6H_profile(veryslow);
+DECLARE_CompressImageBC6H_profile(signed_veryfast);
+DECLARE_CompressImageBC6H_profile(signed_fast);
+DECLARE_CompressImageBC6H_profile(signed_basic);
+DECLARE_CompressImageBC6H_profile(signed_slow);
+DECLARE_CompressImageBC6H_profile(signed_veryslow);
 
 #define DECLARE_CompressImageBC7_profile(profile)                               \
 void CompressImageBC7_ ## profile(const rgba_surface* input, BYTE* output)      \
@@ -91,19 +91,33 @@ DWORD WINAPI CompressImageMT_Thread( LPVOID lpParam );
 
 int GetBytesPerBlock(CompressionFunc* fn);
 bool IsBC6H(CompressionFunc* fn);
+bool IsBC6H_signed(CompressionFunc* fn);
+bool IsBC1(CompressionFunc* fn);
 bool IsBC4(CompressionFunc* fn);
 bool IsBC5(CompressionFunc* fn);
 DXGI_FORMAT GetFormatFromCompressionFunc(CompressionFunc* fn);
 
 void CompressImageBC1(const rgba_surface* input, BYTE* output);
+void CompressImageBC1_ultrafast(const rgba_surface* input, BYTE* output);
+void CompressImageBC1_veryfast(const rgba_surface* input, BYTE* output);
+void CompressImageBC1_fast(const rgba_surface* input, BYTE* output);
+void CompressImageBC1_slow(const rgba_surface* input, BYTE* output);
+void CompressImageBC1A(const rgba_surface* input, BYTE* output);
 void CompressImageBC3(const rgba_surface* input, BYTE* output);
 void CompressImageBC4(const rgba_surface* input, BYTE* output);
 void CompressImageBC5(const rgba_surface* input, BYTE* output);
+void CompressImageBC4_slow(const rgba_surface* input, BYTE* output);
+void CompressImageBC5_slow(const rgba_surface* input, BYTE* output);
 void CompressImageBC6H_veryfast(const rgba_surface* input, BYTE* output);
 void CompressImageBC6H_fast(const rgba_surface* input, BYTE* output);
 void CompressImageBC6H_basic(const rgba_surface* input, BYTE* output);
 void CompressImageBC6H_slow(const rgba_surface* input, BYTE* output);
 void CompressImageBC6H_veryslow(const rgba_surface* input, BYTE* output);
+void CompressImageBC6H_signed_veryfast(const rgba_surface* input, BYTE* output);
+void CompressImageBC6H_signed_fast(const rgba_surface* input, BYTE* output);
+void CompressImageBC6H_signed_basic(const rgba_surface* input, BYTE* output);
+void CompressImageBC6H_signed_slow(const rgba_surface* input, BYTE* output);
+void CompressImageBC6H_signed_veryslow(const rgba_surface* input, BYTE* output);
 void CompressImageBC7_ultrafast(const rgba_surface* input, BYTE* output);
 void CompressImageBC7_veryfast(const rgba_surface* input, BYTE* output);
 void CompressImageBC7_fast(const rgba_surface* input, BYTE* output);
@@ -22,7 +22,11 @@
 
 #include "ispc_texcomp.h"
 #include "kernel_ispc.h"
+#include "kernel_int_ispc.h"
 #include <memory.h> // memcpy
+#include <vector>
+#include <limits>
+#include <algorithm> // std::min
 
 void GetProfile_ultrafast(bc7_enc_settings* settings)
 {
@@ -43,12 +47,14 @@ void GetProfile_ultrafast(bc7_enc_settings* settings)
 
 	settings->refineIterations[1] = 2;
 	settings->refineIterations[3] = 1;
+	settings->refineIterations[7] = 0;
 
 	// mode45
 	settings->mode_selection[2] = false;
 
     settings->mode45_channel0 = 0;
 	settings->refineIterations_channel = 0;
+	settings->mode45_rotation_candidates = 0;
 	settings->refineIterations[4] = 2;
 	settings->refineIterations[5] = 2;
 
@@ -56,6 +62,10 @@ void GetProfile_ultrafast(bc7_enc_settings* settings)
 	settings->mode_selection[3] = true;
 
 	settings->refineIterations[6] = 1;
+
+	settings->partition_binning = false;
+	settings->target_error = 0;
+	settings->rdo_lambda = 0;
 }
 
 void GetProfile_veryfast(bc7_enc_settings* settings)
@@ -77,12 +87,14 @@ void GetProfile_veryfast(bc7_enc_settings* settings)
 
 	settings->refineIterations[1] = 2;
 	settings->refineIterations[3] = 1;
+	settings->refineIterations[7] = 0;
 
 	// mode45
 	settings->mode_selection[2] = false;
 
     settings->mode45_channel0 = 0;
 	settings->refineIterations_channel = 0;
+	settings->mode45_rotation_candidates = 0;
 	settings->refineIterations[4] = 2;
 	settings->refineIterations[5] = 2;
 
@@ -90,6 +102,10 @@ void GetProfile_veryfast(bc7_enc_settings* settings)
 	settings->mode_selection[3] = true;
 
 	settings->refineIterations[6] = 1;
+
+	settings->partition_binning = false;
+	settings->target_error = 0;
+	settings->rdo_lambda = 0;
 }
 
 void GetProfile_fast(bc7_enc_settings* settings)
@@ -111,12 +127,14 @@ void GetProfile_fast(bc7_enc_settings* settings)
 
 	settings->refineIterations[1] = 2;
 	settings->refineIterations[3] = 1;
+	settings->refineIterations[7] = 0;
 
 	// mode45
 	settings->mode_selection[2] = false;
 
     settings->mode45_channel0 = 0;
 	settings->refineIterations_channel = 0;
+	settings->mode45_rotation_candidates = 0;
 	settings->refineIterations[4] = 2;
 	settings->refineIterations[5] = 2;
 
@@ -124,6 +142,10 @@ void GetProfile_fast(bc7_enc_settings* settings)
 	settings->mode_selection[3] = true;
 
 	settings->refineIterations[6] = 2;
+
+	settings->partition_binning = false;
+	settings->target_error = 0;
+	settings->rdo_lambda = 0;
 }
 
 void GetProfile_basic(bc7_enc_settings* settings)
@@ -145,12 +167,14 @@ void GetProfile_basic(bc7_enc_settings* settings)
 
 	settings->refineIterations[1] = 2;
 	settings->refineIterations[3] = 2;
+	settings->refineIterations[7] = 0;
 
 	// mode45
 	settings->mode_selection[2] = true;
 
     settings->mode45_channel0 = 0;
 	settings->refineIterations_channel = 2;
+	settings->mode45_rotation_candidates = 0;
 	settings->refineIterations[4] = 2;
 	settings->refineIterations[5] = 2;
 
@@ -158,6 +182,10 @@ void GetProfile_basic(bc7_enc_settings* settings)
 	settings->mode_selection[3] = true;
 
 	settings->refineIterations[6] = 2;
+
+	settings->partition_binning = false;
+	settings->target_error = 0;
+	settings->rdo_lambda = 0;
 }
 
 void GetProfile_slow(bc7_enc_settings* settings)
@@ -180,12 +208,14 @@ void GetProfile_slow(bc7_enc_settings* settings)
 
 	settings->refineIterations[1] = 2+moreRefine;
 	settings->refineIterations[3] = 2+moreRefine;
+	settings->refineIterations[7] = 0;
 
 	// mode45
 	settings->mode_selection[2] = true;
 
     settings->mode45_channel0 = 0;
 	settings->refineIterations_channel = 2+moreRefine;
+	settings->mode45_rotation_candidates = 0;
 	settings->refineIterations[4] = 2+moreRefine;
 	settings->refineIterations[5] = 2+moreRefine;
 
@@ -193,6 +223,10 @@ void GetProfile_slow(bc7_enc_settings* settings)
 	settings->mode_selection[3] = true;
 
 	settings->refineIterations[6] = 2+moreRefine;
+
+	settings->partition_binning = false;
+	settings->target_error = 0;
+	settings->rdo_lambda = 0;
 }
 
 void GetProfile_alpha_ultrafast(bc7_enc_settings* settings)
@@ -221,6 +255,7 @@ void GetProfile_alpha_ultrafast(bc7_enc_settings* settings)
     
     settings->mode45_channel0 = 3;
     settings->refineIterations_channel = 1;
+    settings->mode45_rotation_candidates = 0;
 	settings->refineIterations[4] = 1;
 	settings->refineIterations[5] = 1;
 
@@ -228,6 +263,10 @@ void GetProfile_alpha_ultrafast(bc7_enc_settings* settings)
 	settings->mode_selection[3] = true;
 
 	settings->refineIterations[6] = 2;
+
+	settings->partition_binning = false;
+	settings->target_error = 0;
+	settings->rdo_lambda = 0;
 }
 
 void GetProfile_alpha_veryfast(bc7_enc_settings* settings)
@@ -256,6 +295,7 @@ void GetProfile_alpha_veryfast(bc7_enc_settings* settings)
     
     settings->mode45_channel0 = 3;
     settings->refineIterations_channel = 2;
+    settings->mode45_rotation_candidates = 0;
 	settings->refineIterations[4] = 2;
 	settings->refineIterations[5] = 2;
 
@@ -263,6 +303,10 @@ void GetProfile_alpha_veryfast(bc7_enc_settings* settings)
 	settings->mode_selection[3] = true;
 
 	settings->refineIterations[6] = 2;
+
+	settings->partition_binning = false;
+	settings->target_error = 0;
+	settings->rdo_lambda = 0;
 }
 
 void GetProfile_alpha_fast(bc7_enc_settings* settings)
@@ -291,6 +335,7 @@ void GetProfile_alpha_fast(bc7_enc_settings* settings)
     
     settings->mode45_channel0 = 3;
     settings->refineIterations_channel = 2;
+    settings->mode45_rotation_candidates = 0;
 	settings->refineIterations[4] = 2;
 	settings->refineIterations[5] = 2;
 
@@ -298,6 +343,10 @@ void GetProfile_alpha_fast(bc7_enc_settings* settings)
 	settings->mode_selection[3] = true;
 
 	settings->refineIterations[6] = 2;
+
+	settings->partition_binning = false;
+	settings->target_error = 0;
+	settings->rdo_lambda = 0;
 }
 
 void GetProfile_alpha_basic(bc7_enc_settings* settings)
@@ -326,6 +375,7 @@ void GetProfile_alpha_basic(bc7_enc_settings* settings)
     
     settings->mode45_channel0 = 0;
     settings->refineIterations_channel = 2;
+    settings->mode45_rotation_candidates = 0;
 	settings->refineIterations[4] = 2;
 	settings->refineIterations[5] = 2;
 
@@ -333,6 +383,10 @@ void GetProfile_alpha_basic(bc7_enc_settings* settings)
 	settings->mode_selection[3] = true;
 
 	settings->refineIterations[6] = 2;
+
+	settings->partition_binning = false;
+	settings->target_error = 0;
+	settings->rdo_lambda = 0;
 }
 
 void GetProfile_alpha_slow(bc7_enc_settings* settings)
@@ -362,6 +416,7 @@ void GetProfile_alpha_slow(bc7_enc_settings* settings)
 
     settings->mode45_channel0 = 0;
 	settings->refineIterations_channel = 2+moreRefine;
+	settings->mode45_rotation_candidates = 0;
 	settings->refineIterations[4] = 2+moreRefine;
 	settings->refineIterations[5] = 2+moreRefine;
 
@@ -369,6 +424,10 @@ void GetProfile_alpha_slow(bc7_enc_settings* settings)
 	settings->mode_selection[3] = true;
 
 	settings->refineIterations[6] = 2+moreRefine;
+
+	settings->partition_binning = false;
+	settings->target_error = 0;
+	settings->rdo_lambda = 0;
 }
 
 void GetProfile_bc6h_veryfast(bc6h_enc_settings* settings)
@@ -378,6 +437,7 @@ void GetProfile_bc6h_veryfast(bc6h_enc_settings* settings)
     settings->fastSkipTreshold = 0;
     settings->refineIterations_1p = 0;
     settings->refineIterations_2p = 0;
+    settings->signed_format = false;
 }
 
 void GetProfile_bc6h_fast(bc6h_enc_settings* settings)
@@ -387,6 +447,7 @@ void GetProfile_bc6h_fast(bc6h_enc_settings* settings)
     settings->fastSkipTreshold = 2;
     settings->refineIterations_1p = 0;
     settings->refineIterations_2p = 1;
+    settings->signed_format = false;
 }
 
 void GetProfile_bc6h_basic(bc6h_enc_settings* settings)
@@ -396,6 +457,7 @@ void GetProfile_bc6h_basic(bc6h_enc_settings* settings)
     settings->fastSkipTreshold = 4;
     settings->refineIterations_1p = 2;
     settings->refineIterations_2p = 2;
+    settings->signed_format = false;
 }
 
 void GetProfile_bc6h_slow(bc6h_enc_settings* settings)
@@ -405,6 +467,7 @@ void GetProfile_bc6h_slow(bc6h_enc_settings* settings)
     settings->fastSkipTreshold = 10;
     settings->refineIterations_1p = 2;
     settings->refineIterations_2p = 2;
+    settings->signed_format = false;
 }
 
 void GetProfile_bc6h_veryslow(bc6h_enc_settings* settings)
@@ -414,11 +477,155 @@ void GetProfile_bc6h_veryslow(bc6h_enc_settings* settings)
     settings->fastSkipTreshold = 32;
     settings->refineIterations_1p = 2;
     settings->refineIterations_2p = 2;
+    settings->signed_format = false;
+}
+
+void GetProfile_bc6h_signed_veryfast(bc6h_enc_settings* settings)
+{
+    GetProfile_bc6h_veryfast(settings);
+    settings->signed_format = true;
+}
+
+void GetProfile_bc6h_signed_fast(bc6h_enc_settings* settings)
+{
+    GetProfile_bc6h_fast(settings);
+    settings->signed_format = true;
+}
+
+void GetProfile_bc6h_signed_basic(bc6h_enc_settings* settings)
+{
+    GetProfile_bc6h_basic(settings);
+    settings->signed_format = true;
+}
+
+void GetProfile_bc6h_signed_slow(bc6h_enc_settings* settings)
+{
+    GetProfile_bc6h_slow(settings);
+    settings->signed_format = true;
+}
+
+void GetProfile_bc6h_signed_veryslow(bc6h_enc_settings* settings)
+{
+    GetProfile_bc6h_veryslow(settings);
+    settings->signed_format = true;
+}
+
+void GetProfile_bc1_ultrafast(bc1_enc_settings* settings)
+{
+    settings->bounding_box = true;
+    settings->powerIterations = 0;
+    settings->refineIterations = 0;
+    settings->cluster_fit = false;
+    settings->alpha_threshold = 0;
+    settings->three_color_mode = false;
+    settings->three_color_black = false;
+}
+
+void GetProfile_bc1_veryfast(bc1_enc_settings* settings)
+{
+    settings->bounding_box = true;
+    settings->powerIterations = 0;
+    settings->refineIterations = 1;
+    settings->cluster_fit = false;
+    settings->alpha_threshold = 0;
+    settings->three_color_mode = false;
+    settings->three_color_black = false;
+}
+
+void GetProfile_bc1_fast(bc1_enc_settings* settings)
+{
+    settings->bounding_box = false;
+    settings->powerIterations = 2;
+    settings->refineIterations = 1;
+    settings->cluster_fit = false;
+    settings->alpha_threshold = 0;
+    settings->three_color_mode = false;
+    settings->three_color_black = false;
+}
+
+void GetProfile_bc1_basic(bc1_enc_settings* settings)
+{
+    settings->bounding_box = false;
+    settings->powerIterations = 4;
+    settings->refineIterations = 1;
+    settings->cluster_fit = false;
+    settings->alpha_threshold = 0;
+    settings->three_color_mode = false;
+    settings->three_color_black = false;
+}
+
+void GetProfile_bc1_slow(bc1_enc_settings* settings)
+{
+    settings->bounding_box = false;
+    settings->powerIterations = 8;
+    settings->refineIterations = 2;
+    settings->cluster_fit = true;
+    settings->alpha_threshold = 0;
+    settings->three_color_mode = true;
+    settings->three_color_black = false;
+}
+
+void GetProfile_bc4_fast(bc4_enc_settings* settings)
+{
+    settings->refineIterations = 0;
+    settings->six_value_mode = false;
+    settings->snorm = false;
+}
+
+void GetProfile_bc4_basic(bc4_enc_settings* settings)
+{
+    settings->refineIterations = 2;
+    settings->six_value_mode = true;
+    settings->snorm = false;
+}
+
+void GetProfile_bc4_slow(bc4_enc_settings* settings)
+{
+    settings->refineIterations = 8;
+    settings->six_value_mode = true;
+    settings->snorm = false;
+}
+
+void GetProfile_bc4_snorm_fast(bc4_enc_settings* settings)
+{
+    settings->refineIterations = 0;
+    settings->six_value_mode = false;
+    settings->snorm = true;
+}
+
+void GetProfile_bc4_snorm_basic(bc4_enc_settings* settings)
+{
+    settings->refineIterations = 2;
+    settings->six_value_mode = true;
+    settings->snorm = true;
+}
+
+void GetProfile_bc4_snorm_slow(bc4_enc_settings* settings)
+{
+    settings->refineIterations = 8;
+    settings->six_value_mode = true;
+    settings->snorm = true;
+}
+
+void GetProfile_etc_ultrafast(etc_enc_settings* settings)
+{
+    settings->fastSkipTreshold = 1;
+    settings->single_flip = true;
+    settings->table_window = 2;
+}
+
+void GetProfile_etc_fast(etc_enc_settings* settings)
+{
+    settings->fastSkipTreshold = 3;
+    settings->single_flip = true;
+    settings->table_window = 3;
 }
 
 void GetProfile_etc_slow(etc_enc_settings* settings)
 {
     settings->fastSkipTreshold = 6;
+    settings->single_flip = false;
+    settings->table_window = 8;
 }
 
 void ReplicateBorders(rgba_surface* dst_slice, const rgba_surface* src_tex, int start_x, int start_y, int bpp)
@@ -446,37 +653,520 @@ void ReplicateBorders(rgba_surface* dst_slice, const rgba_surface* src_tex, int
     }
 }
 
+void FillBlockTable(uint32_t* table, int blocks_x, int blocks_y, block_address_func func, void* user_data)
+{
+    for (int yy = 0; yy < blocks_y; yy++)
+    for (int xx = 0; xx < blocks_x; xx++)
+    {
+        table[yy * blocks_x + xx] = func(xx, yy, user_data);
+    }
+}
+
+// an unknown dst_order, a tile size below 1 or a missing block table writes raster order instead
+// (the kernels would divide by zero or read through the NULL table)
+const rgba_surface* checked_order(const rgba_surface* src, rgba_surface* raster)
+{
+    bool valid = src->dst_order == ORDER_RASTER || src->dst_order == ORDER_MORTON ||
+        (src->dst_order == ORDER_TILED && src->dst_tile_width > 0 && src->dst_tile_height > 0) ||
+        (src->dst_order == ORDER_TABLE && src->dst_blocks);
+    if (valid) return src;
+
+    *raster = *src;
+    raster->dst_order = ORDER_RASTER;
+    return raster;
+}
+
 void CompressBlocksBC1(const rgba_surface* src, uint8_t* dst)
 {
-	ispc::CompressBlocksBC1_ispc((ispc::rgba_surface*)src, dst);
+    bc1_enc_settings settings;
+    GetProfile_bc1_basic(&settings);
+    CompressBlocksBC1_settings(src, dst, &settings);
 }
 
 void CompressBlocksBC3(const rgba_surface* src, uint8_t* dst)
 {
-	ispc::CompressBlocksBC3_ispc((ispc::rgba_surface*)src, dst);
+    bc1_enc_settings settings;
+    GetProfile_bc1_basic(&settings);
+    CompressBlocksBC3_settings(src, dst, &settings);
+}
+
+// bounding box endpoints without refinement run the integer kernels (kernel_int.ispc)
+bool surface_is_native(const rgba_surface* src, int format)
+{
+    return (src->format == SURFACE_NATIVE || src->format == format) &&
+        src->swizzle[0] == SWIZZLE_KEEP && src->swizzle[1] == SWIZZLE_KEEP &&
+        src->swizzle[2] == SWIZZLE_KEEP && src->swizzle[3] == SWIZZLE_KEEP;
+}
+
+bool bc1_use_int_kernel(const rgba_surface* src, const bc1_enc_settings* settings)
+{
+    return surface_is_native(src, SURFACE_RGBA8) && settings->bounding_box && settings->refineIterations == 0 && !settings->cluster_fit &&
+        settings->alpha_threshold == 0 && !settings->three_color_mode;
+}
+
+void CompressBlocksBC1_settings(const rgba_surface* src, uint8_t* dst, bc1_enc_settings* settings)
+{
+    rgba_surface raster;
+    src = checked_order(src, &raster);
+
+    if (bc1_use_int_kernel(src, settings))
+    {
+        ispc::CompressBlocksBC1_int_ispc((ispc::rgba_surface*)src, dst);
+        return;
+    }
+
+	ispc::CompressBlocksBC1_ispc((ispc::rgba_surface*)src, dst, (ispc::bc1_enc_settings*)settings);
+}
+
+void CompressBlocksBC3_settings(const rgba_surface* src, uint8_t* dst, bc1_enc_settings* settings)
+{
+    rgba_surface raster;
+    src = checked_order(src, &raster);
+
+    if (bc1_use_int_kernel(src, settings))
+    {
+        ispc::CompressBlocksBC3_int_ispc((ispc::rgba_surface*)src, dst);
+        return;
+    }
+
+	ispc::CompressBlocksBC3_ispc((ispc::rgba_surface*)src, dst, (ispc::bc1_enc_settings*)settings);
 }
 
 void CompressBlocksBC4(const rgba_surface* src, uint8_t* dst)
 {
-	ispc::CompressBlocksBC4_ispc((ispc::rgba_surface*)src, dst);
+    bc4_enc_settings settings;
+    GetProfile_bc4_fast(&settings);
+    CompressBlocksBC4_settings(src, dst, &settings);
 }
 
 void CompressBlocksBC5(const rgba_surface* src, uint8_t* dst)
 {
-	ispc::CompressBlocksBC5_ispc((ispc::rgba_surface*)src, dst);
+    bc4_enc_settings settings;
+    GetProfile_bc4_fast(&settings);
+    CompressBlocksBC5_settings(src, dst, &settings);
+}
+
+// min/max endpoints without 6-value mode run the integer kernels (kernel_int.ispc)
+bool bc4_use_int_kernel(const rgba_surface* src, const bc4_enc_settings* settings, int native_format)
+{
+    // the packed int loaders read whole rows of 4 texels, partial edge blocks need the clamped float loaders
+    return surface_is_native(src, native_format) && src->width % 4 == 0 &&
+        settings->refineIterations == 0 && !settings->six_value_mode && !settings->snorm;
+}
+
+void CompressBlocksBC4_settings(const rgba_surface* src, uint8_t* dst, bc4_enc_settings* settings)
+{
+    rgba_surface raster;
+    src = checked_order(src, &raster);
+
+    if (bc4_use_int_kernel(src, settings, SURFACE_R8))
+    {
+        ispc::CompressBlocksBC4_int_ispc((ispc::rgba_surface*)src, dst);
+        return;
+    }
+
+	ispc::CompressBlocksBC4_ispc((ispc::rgba_surface*)src, dst, (ispc::bc4_enc_settings*)settings);
+}
+
+void CompressBlocksBC5_settings(const rgba_surface* src, uint8_t* dst, bc4_enc_settings* settings)
+{
+    rgba_surface raster;
+    src = checked_order(src, &raster);
+
+    if (bc4_use_int_kernel(src, settings, SURFACE_RG8))
+    {
+        ispc::CompressBlocksBC5_int_ispc((ispc::rgba_surface*)src, dst);
+        return;
+    }
+
+	ispc::CompressBlocksBC5_ispc((ispc::rgba_surface*)src, dst, (ispc::bc4_enc_settings*)settings);
+}
+
+bool bc4_outputs_valid(const bc4_output* outputs, int output_count)
+{
+    if (output_count < 0 || (output_count > 0 && !outputs)) return false;
+
+    for (int o = 0; o < output_count; o++)
+    {
+        if (!outputs[o].dst || outputs[o].channels < 1 || outputs[o].channels > 2) return false;
+        for (int i = 0; i < outputs[o].channels; i++)
+            if (outputs[o].channel[i] < 0 || outputs[o].channel[i] > 3) return false;
+    }
+
+    return true;
+}
+
+void CompressBlocksBC4BC5_multi(const rgba_surface* src, bc4_output* outputs, int output_count, bc4_enc_settings* settings)
+{
+    if (!bc4_outputs_valid(outputs, output_count)) return;
+
+    rgba_surface raster;
+    src = checked_order(src, &raster);
+
+    ispc::CompressBlocksBC4BC5_multi_ispc((ispc::rgba_surface*)src, (ispc::bc4_output*)outputs, output_count, 
+                                          (ispc::bc4_enc_settings*)settings);
+}
+
+void bc7_rank(const rgba_surface* src, int xx, int yy, uint8_t* dst, float* block_scores, uint32_t* candidates, bc7_enc_settings* settings, 
+              int* skip_counts)
+{
+    ispc::bc7_rank_ispc((ispc::rgba_surface*)src, xx, yy, dst, block_scores, candidates, (ispc::bc7_enc_settings*)settings, skip_counts);
+}
+
+void bc7_refine(const rgba_surface* src, float* block_scores, uint8_t* dst, uint64_t* list, int mode, int part_id, bc7_enc_settings* settings)
+{
+    ispc::bc7_refine_ispc((ispc::rgba_surface*)src, block_scores, dst, list, mode, part_id, (ispc::bc7_enc_settings*)settings);
+}
+
+// two-phase encoding: blocks are binned by their best (mode, partition) candidates,
+// so that the refinement runs with uniform partition data across the gang
+void CompressBlocksBC7_binned(const rgba_surface* src, uint8_t* dst, bc7_enc_settings* settings, int* skip_counts)
+{
+    int tex_width = (src->width + 3) / 4;
+    int tex_height = (src->height + 3) / 4;
+    int programCount = ispc::bc7_get_programCount();
+
+    std::vector<float> block_scores(tex_width * tex_height);
+
+    for (int yy = 0; yy < tex_height; yy++)
+    for (int xx = 0; xx < tex_width; xx++)
+    {
+        block_scores[yy * tex_width + xx] = std::numeric_limits<float>::infinity();
+    }
+
+    int part_list_size = 8 * 128; // bin = mode*128 + part_id
+    int list_size = programCount;
+    std::vector<uint64_t> part_lists(list_size * part_list_size);
+    std::vector<uint32_t> candidates(programCount * 8);
+
+    for (int yy = 0; yy < tex_height; yy++)
+    for (int _x = 0; _x < (tex_width + programCount - 1) / programCount; _x++)
+    {
+        int xx = _x * programCount;
+        memset(candidates.data(), 0, candidates.size() * sizeof(uint32_t));
+        bc7_rank(src, xx, yy, dst, block_scores.data(), candidates.data(), settings, skip_counts);
+
+        for (int mode = 0; mode < 8; mode++)
+        for (int k = 0; k < programCount; k++)
+        {
+            if (xx + k >= tex_width) continue;
+
+            uint32_t candidate = candidates[programCount * mode + k];
+            if (candidate == 0) continue;
+
+            uint32_t offset = (yy << 16) + (xx + k);
+            int part_id = candidate - 1;
+            uint64_t* part_list = &part_lists[list_size * (mode * 128 + part_id)];
+
+            if (*part_list < uint64_t(programCount - 1))
+            {
+                int index = int(part_list[0] + 1);
+                part_list[0] = index;
+
+                part_list[index] = (uint64_t(offset) << 32) + candidate;
+            }
+            else
+            {
+                part_list[0] = (uint64_t(offset) << 32) + candidate;
+
+                bc7_refine(src, block_scores.data(), dst, part_list, mode, part_id, settings);
+                memset(part_list, 0, list_size * sizeof(uint64_t));
+            }
+        }
+    }
+
+    for (int bin = 0; bin < part_list_size; bin++)
+    {
+        uint64_t* part_list = &part_lists[list_size * bin];
+        if (part_list[0] == 0) continue;
+        part_list[0] = 0;
+
+        bc7_refine(src, block_scores.data(), dst, part_list, bin / 128, bin % 128, settings);
+        memset(part_list, 0, list_size * sizeof(uint64_t));
+    }
+}
+
+bool bc7_settings_equal(const bc7_enc_settings* a, const bc7_enc_settings* b)
+{
+    for (int i = 0; i < 4; i++) if (a->mode_selection[i] != b->mode_selection[i]) return false;
+    for (int i = 0; i < 8; i++) if (a->refineIterations[i] != b->refineIterations[i]) return false;
+
+    return a->skip_mode2 == b->skip_mode2
+        && a->fastSkipTreshold_mode1 == b->fastSkipTreshold_mode1
+        && a->fastSkipTreshold_mode3 == b->fastSkipTreshold_mode3
+        && a->fastSkipTreshold_mode7 == b->fastSkipTreshold_mode7
+        && a->mode45_channel0 == b->mode45_channel0
+        && a->refineIterations_channel == b->refineIterations_channel
+        && a->mode45_rotation_candidates == b->mode45_rotation_candidates
+        && a->channels == b->channels
+        && a->partition_binning == b->partition_binning
+        && a->target_error == b->target_error
+        && a->rdo_lambda == b->rdo_lambda;
+}
+
+// index of the specialized kernel matching the settings, -1 for custom settings
+int bc7_find_profile(const bc7_enc_settings* settings)
+{
+    for (int profile = 0; profile < ispc::bc7_get_profile_count(); profile++)
+    {
+        bc7_enc_settings profile_settings;
+        ispc::bc7_get_profile_ispc(profile, (ispc::bc7_enc_settings*)&profile_settings);
+        if (bc7_settings_equal(settings, &profile_settings)) return profile;
+    }
+
+    return -1;
+}
+
+void CompressBlocksBC7_impl(const rgba_surface* src, uint8_t* dst, bc7_enc_settings* settings, int* skip_counts)
+{
+    rgba_surface raster;
+    src = checked_order(src, &raster);
+
+    if (settings->partition_binning)
+    {
+        CompressBlocksBC7_binned(src, dst, settings, skip_counts);
+        return;
+    }
+
+    int profile = bc7_find_profile(settings);
+    if (profile >= 0)
+    {
+        ispc::CompressBlocksBC7_profile_ispc((ispc::rgba_surface*)src, dst, profile, skip_counts);
+        return;
+    }
+
+	ispc::CompressBlocksBC7_ispc((ispc::rgba_surface*)src, dst, (ispc::bc7_enc_settings*)settings, skip_counts);
 }
 
 void CompressBlocksBC7(const rgba_surface* src, uint8_t* dst, bc7_enc_settings* settings)
 {
-	ispc::CompressBlocksBC7_ispc((ispc::rgba_surface*)src, dst, (ispc::bc7_enc_settings*)settings);
+    CompressBlocksBC7_impl(src, dst, settings, NULL);
+}
+
+void CompressBlocksBC7_stats(const rgba_surface* src, uint8_t* dst, bc7_enc_settings* settings, bc7_enc_stats* stats)
+{
+    stats->blocks += ((src->width + 3) / 4) * ((src->height + 3) / 4);
+    CompressBlocksBC7_impl(src, dst, settings, stats->mode_skips);
+}
+
+void bc6h_rank(const rgba_surface* src, int xx, int yy, uint8_t* dst, float* block_scores, int* modes, bc6h_enc_settings* settings)
+{
+    ispc::bc6h_rank_ispc((ispc::rgba_surface*)src, xx, yy, dst, block_scores, modes, (ispc::bc6h_enc_settings*)settings);
+}
+
+void bc6h_encode_bin(const rgba_surface* src, float* block_scores, uint8_t* dst, uint64_t* list, int mode, bc6h_enc_settings* settings)
+{
+    ispc::bc6h_encode_bin_ispc((ispc::rgba_surface*)src, block_scores, dst, list, mode, (ispc::bc6h_enc_settings*)settings);
+}
+
+// fast modes: blocks are binned by their preselected 2p and 1p modes across the image,
+// so that each bin encodes with a uniform mode (precision and packing) across the gang
+void CompressBlocksBC6H_binned(const rgba_surface* src, uint8_t* dst, bc6h_enc_settings* settings)
+{
+    int tex_width = (src->width + 3) / 4;
+    int tex_height = (src->height + 3) / 4;
+    int programCount = ispc::bc7_get_programCount();
+
+    std::vector<float> block_scores(tex_width * tex_height);
+
+    int mode_count = 14; // bin = mode
+    int list_size = programCount;
+    std::vector<uint64_t> mode_lists(list_size * mode_count);
+    std::vector<int> modes(programCount * 2);
+
+    for (int yy = 0; yy < tex_height; yy++)
+    for (int _x = 0; _x < (tex_width + programCount - 1) / programCount; _x++)
+    {
+        int xx = _x * programCount;
+        bc6h_rank(src, xx, yy, dst, block_scores.data(), modes.data(), settings);
+
+        for (int i = 0; i < 2; i++)
+        for (int k = 0; k < programCount; k++)
+        {
+            if (xx + k >= tex_width) continue;
+
+            int mode = modes[programCount * i + k];
+            if (mode < 0) continue;
+
+            uint32_t offset = (yy << 16) + (xx + k);
+            uint64_t* mode_list = &mode_lists[list_size * mode];
+
+            if (*mode_list < uint64_t(programCount - 1))
+            {
+                int index = int(mode_list[0] + 1);
+                mode_list[0] = index;
+
+                mode_list[index] = (uint64_t(offset) << 32) + mode + 1;
+            }
+            else
+            {
+                mode_list[0] = (uint64_t(offset) << 32) + mode + 1;
+
+                bc6h_encode_bin(src, block_scores.data(), dst, mode_list, mode, settings);
+                memset(mode_list, 0, list_size * sizeof(uint64_t));
+            }
+        }
+    }
+
+    for (int mode = 0; mode < mode_count; mode++)
+    {
+        uint64_t* mode_list = &mode_lists[list_size * mode];
+        if (mode_list[0] == 0) continue;
+        mode_list[0] = 0;
+
+        bc6h_encode_bin(src, block_scores.data(), dst, mode_list, mode, settings);
+        memset(mode_list, 0, list_size * sizeof(uint64_t));
+    }
 }
 
 void CompressBlocksBC6H(const rgba_surface* src, uint8_t* dst, bc6h_enc_settings* settings)
 {
+    rgba_surface raster;
+    src = checked_order(src, &raster);
+
+    if (!settings->slow_mode)
+    {
+        CompressBlocksBC6H_binned(src, dst, settings);
+        return;
+    }
+
     ispc::CompressBlocksBC6H_ispc((ispc::rgba_surface*)src, dst, (ispc::bc6h_enc_settings*)settings);
 }
 
 void CompressBlocksETC1(const rgba_surface* src, uint8_t* dst, etc_enc_settings* settings)
 {
+    rgba_surface raster;
+    src = checked_order(src, &raster);
     ispc::CompressBlocksETC1_ispc((ispc::rgba_surface*)src, dst, (ispc::etc_enc_settings*)settings);
 }
+
+void CompressBlocksETC2(const rgba_surface* src, uint8_t* dst, etc_enc_settings* settings)
+{
+    rgba_surface raster;
+    src = checked_order(src, &raster);
+    ispc::CompressBlocksETC2_ispc((ispc::rgba_surface*)src, dst, (ispc::etc_enc_settings*)settings);
+}
+
+void CompressBlocksETC2_RGBA(const rgba_surface* src, uint8_t* dst, etc_enc_settings* settings)
+{
+    rgba_surface raster;
+    src = checked_order(src, &raster);
+    ispc::CompressBlocksETC2_RGBA_ispc((ispc::rgba_surface*)src, dst, (ispc::etc_enc_settings*)settings);
+}
+
+void CompressBlocksEAC_R11(const rgba_surface* src, uint8_t* dst)
+{
+    rgba_surface raster;
+    src = checked_order(src, &raster);
+    ispc::CompressBlocksEAC_R11_ispc((ispc::rgba_surface*)src, dst, false);
+}
+
+void CompressBlocksEAC_R11_signed(const rgba_surface* src, uint8_t* dst)
+{
+    rgba_surface raster;
+    src = checked_order(src, &raster);
+    ispc::CompressBlocksEAC_R11_ispc((ispc::rgba_surface*)src, dst, true);
+}
+
+void CompressBlocksEAC_RG11(const rgba_surface* src, uint8_t* dst)
+{
+    rgba_surface raster;
+    src = checked_order(src, &raster);
+    ispc::CompressBlocksEAC_RG11_ispc((ispc::rgba_surface*)src, dst, false);
+}
+
+void CompressBlocksEAC_RG11_signed(const rgba_surface* src, uint8_t* dst)
+{
+    rgba_surface raster;
+    src = checked_order(src, &raster);
+    ispc::CompressBlocksEAC_RG11_ispc((ispc::rgba_surface*)src, dst, true);
+}
+
+struct stream_encoder
+{
+    stream_encoder_desc desc;
+    int row_bytes;                  // source bytes per row
+    int block_row_bytes;            // compressed bytes per block row
+    int rows_received;
+    int band_rows;                  // rows buffered in band
+    int block_row;                  // next block row to output
+    std::vector<uint8_t> band;
+    std::vector<uint8_t> blocks;
+};
+
+stream_encoder* CreateStreamEncoder(const stream_encoder_desc* desc)
+{
+    // bands are cut from ptr/stride rows, planes would not follow them
+    if (desc->surface.format == SURFACE_PLANAR8 || desc->surface.format == SURFACE_PLANAR16F) return NULL;
+
+    // empty bands would never consume rows, and every band calls both callbacks
+    if (desc->surface.width <= 0 || desc->surface.height <= 0 || desc->bytes_per_pixel <= 0) return NULL;
+    if (desc->block_width <= 0 || desc->block_height <= 0 || desc->bytes_per_block <= 0) return NULL;
+    if (!desc->compress || !desc->output) return NULL;
+
+    stream_encoder* encoder = new stream_encoder();
+    encoder->desc = *desc;
+    encoder->row_bytes = desc->surface.width * desc->bytes_per_pixel;
+    encoder->block_row_bytes = (desc->surface.width + desc->block_width - 1) / desc->block_width * desc->bytes_per_block;
+    encoder->rows_received = 0;
+    encoder->band_rows = 0;
+    encoder->block_row = 0;
+    encoder->band.resize(encoder->row_bytes * desc->block_height);
+    encoder->blocks.resize(encoder->block_row_bytes);
+    return encoder;
+}
+
+void stream_encode_band(stream_encoder* encoder, const uint8_t* ptr, int stride, int rows)
+{
+    rgba_surface band = encoder->desc.surface;
+    band.ptr = (uint8_t*)ptr;
+    band.stride = stride;
+    band.height = rows;
+    band.dst_stride = 0;
+    band.dst_order = ORDER_RASTER;
+
+    encoder->desc.compress(&band, encoder->blocks.data(), encoder->desc.user_data);
+    encoder->desc.output(encoder->blocks.data(), encoder->block_row, encoder->block_row_bytes, encoder->desc.user_data);
+    encoder->block_row++;
+}
+
+void StreamEncoderAddRows(stream_encoder* encoder, const uint8_t* rows, int stride, int row_count)
+{
+    int block_height = encoder->desc.block_height;
+    row_count = std::min(row_count, encoder->desc.surface.height - encoder->rows_received);
+
+    while (row_count > 0)
+    {
+        if (encoder->band_rows == 0 && row_count >= block_height)
+        {
+            // a whole band in the caller's buffer, no copy
+            stream_encode_band(encoder, rows, stride, block_height);
+            rows += block_height * stride;
+            row_count -= block_height;
+            encoder->rows_received += block_height;
+            continue;
+        }
+
+        int count = std::min(row_count, block_height - encoder->band_rows);
+        for (int y = 0; y < count; y++)
+        {
+            memcpy(&encoder->band[(encoder->band_rows + y) * encoder->row_bytes], rows + y * stride, encoder->row_bytes);
+        }
+
+        rows += count * stride;
+        row_count -= count;
+        encoder->band_rows += count;
+        encoder->rows_received += count;
+
+        if (encoder->band_rows == block_height || encoder->rows_received == encoder->desc.surface.height)
+        {
+            stream_encode_band(encoder, encoder->band.data(), encoder->row_bytes, encoder->band_rows);
+            encoder->band_rows = 0;
+        }
+    }
+}
+
+void DestroyStreamEncoder(stream_encoder* encoder)
+{
+    delete encoder;
+}
@@ -22,12 +22,91 @@
 
 #include <stdint.h>
 
+// rgba_surface::format, SURFACE_NATIVE is what each encoder reads by default:
+// RGBA8 (LDR), RGBA16F (BC6H), R8 (BC4, EAC R11), RG8 (BC5, EAC RG11)
+enum rgba_surface_format
+{
+    SURFACE_NATIVE = 0,
+    SURFACE_RGBA8,
+    SURFACE_BGRA8,
+    SURFACE_RGB8,           // 24 bit/pixel
+    SURFACE_RGBA16,         // 16 bit UNORM
+    SURFACE_RGBA16F,
+    SURFACE_RGBA32F,
+    SURFACE_R8,
+    SURFACE_RG8,
+    SURFACE_R16,            // 16 bit UNORM
+    SURFACE_PLANAR8,        // one 8 bit UNORM plane per channel, see rgba_surface::planes
+    SURFACE_PLANAR16F,      // one half float plane per channel
+};
+
+// rgba_surface::swizzle, the source of each encoder channel (R, G, B, A)
+enum rgba_surface_swizzle
+{
+    SWIZZLE_KEEP = 0,
+    SWIZZLE_R,
+    SWIZZLE_G,
+    SWIZZLE_B,
+    SWIZZLE_A,
+    SWIZZLE_0,
+    SWIZZLE_1,
+};
+
+// rgba_surface::dst_order, the position of block (xx, yy) in dst; unknown values, ORDER_TILED with a
+// tile size below 1 and ORDER_TABLE without dst_blocks fall back to ORDER_RASTER
+enum rgba_surface_order
+{
+    ORDER_RASTER = 0,       // rows of blocks, dst_stride apart
+    ORDER_MORTON,           // Z-order of the block coordinates (sized for the enclosing power of two square)
+    ORDER_TILED,            // raster tiles of dst_tile_width x dst_tile_height blocks, raster inside each tile
+    ORDER_TABLE,            // dst_blocks[yy * blocks per row + xx] (in blocks), see FillBlockTable
+};
+
+// C++14 or later: aggregate initialization (rgba_surface s = { ptr, width, height, stride };) with
+// the default member initializers below needs it, the other members keep their defaults
 struct rgba_surface
 {
     uint8_t* ptr;
     int32_t width;
     int32_t height;
     int32_t stride; // in bytes
+    int32_t format = SURFACE_NATIVE;
+    uint8_t swizzle[4] = { SWIZZLE_KEEP, SWIZZLE_KEEP, SWIZZLE_KEEP, SWIZZLE_KEEP };
+    // SURFACE_PLANAR8/16F only (ptr and stride are unused): R, G, B, A planes and their strides in bytes,
+    // a NULL plane reads as 0 (R, G, B) or 1 (A)
+    uint8_t* planes[4] = {};
+    int32_t plane_stride[4] = {};
+    int32_t dst_stride = 0; // bytes per row of blocks in dst (multiple of 4), 0: tightly packed
+    int32_t dst_order = ORDER_RASTER;
+    int32_t dst_tile_width = 0;
+    int32_t dst_tile_height = 0;
+    const uint32_t* dst_blocks = nullptr;
+};
+
+struct bc1_enc_settings
+{
+    bool bounding_box;      // endpoints from the color bounding box, no covariance/power iteration
+    int powerIterations;
+    int refineIterations;
+    bool cluster_fit;       // exhaustive search over index clusters along the principal axis (slow)
+    int alpha_threshold;    // BC1A: pixels with alpha below are transparent (3-color mode), 0: alpha ignored
+    bool three_color_mode;  // also try 3-color mode on opaque blocks
+    bool three_color_black; // 3-color index 3 may encode black (only when alpha is ignored, readers must not treat it as transparent)
+};
+
+struct bc4_enc_settings
+{
+    int refineIterations;   // least squares endpoint refits, 0: min/max endpoints only
+    bool six_value_mode;    // also try 6-value mode (explicit 0/255 codes) on blocks with extreme values
+    bool snorm;             // input is signed 8 bit, output is BC4_SNORM/BC5_SNORM
+};
+
+struct bc4_output
+{
+    uint8_t* dst;           // BC4 blocks for channels = 1, BC5 blocks for channels = 2
+    int stride;             // bytes per row of blocks in dst, 0: tightly packed
+    int channels;
+    int channel[2];         // source channel of each BC4 block (0: R, 1: G, 2: B, 3: A)
 };
 
 struct bc7_enc_settings
@@ -42,8 +121,21 @@ struct bc7_enc_settings
 
     int mode45_channel0;
     int refineIterations_channel;
+    int mode45_rotation_candidates; // mode 4/5: fully encode only the k best rotations/swaps by estimate (0: all)
 
     int channels;
+
+    bool partition_binning; // two-phase encoding, refinement batched by (mode, partition)
+    float target_error;     // stop the mode search once the block error is below (sum of squared errors, 0: off)
+    float rdo_lambda;       // error increase accepted per byte repeated from the block above (0: off)
+};
+
+// updated without synchronization: use one bc7_enc_stats per thread and sum them afterwards
+struct bc7_enc_stats
+{
+    int blocks;
+    int mode_skips[8];      // blocks where the mode was not evaluated as target_error was already reached
+                            // (with partition_binning every mode is searched, only its refinement may be dropped)
 };
 
 struct bc6h_enc_settings
@@ -53,11 +145,14 @@ struct bc6h_enc_settings
     int refineIterations_1p;
     int refineIterations_2p;
     int fastSkipTreshold;
+    bool signed_format;     // BC6H_SF16 (input halfs may be negative), BC6H_UF16 otherwise
 };
 
 struct etc_enc_settings
 {
-    int fastSkipTreshold;
+    int fastSkipTreshold;   // level split candidates refined per half (at most 8, at most 48 / table_window)
+    bool single_flip;       // only the flip splitting across the stronger edge, otherwise both
+    int table_window;       // tables searched around the luma spread of each half, clamped to 1..8 (8: all)
 };
 
 struct astc_enc_settings
@@ -70,6 +165,21 @@ struct astc_enc_settings
     int refineIterations;
 };
 
+// profiles for BC1/BC3 (color part)
+extern "C" void GetProfile_bc1_ultrafast(bc1_enc_settings* settings);
+extern "C" void GetProfile_bc1_veryfast(bc1_enc_settings* settings);
+extern "C" void GetProfile_bc1_fast(bc1_enc_settings* settings);
+extern "C" void GetProfile_bc1_basic(bc1_enc_settings* settings);
+extern "C" void GetProfile_bc1_slow(bc1_enc_settings* settings);
+
+// profiles for BC4/BC5 (UNORM and SNORM)
+extern "C" void GetProfile_bc4_fast(bc4_enc_settings* settings);
+extern "C" void GetProfile_bc4_basic(bc4_enc_settings* settings);
+extern "C" void GetProfile_bc4_slow(bc4_enc_settings* settings);
+extern "C" void GetProfile_bc4_snorm_fast(bc4_enc_settings* settings);
+extern "C" void GetProfile_bc4_snorm_basic(bc4_enc_settings* settings);
+extern "C" void GetProfile_bc4_snorm_slow(bc4_enc_settings* settings);
+
 // profiles for RGB data (alpha channel will be ignored)
 extern "C" void GetProfile_ultrafast(bc7_enc_settings* settings);
 extern "C" void GetProfile_veryfast(bc7_enc_settings* settings);
@@ -91,7 +201,16 @@ extern "C" void GetProfile_bc6h_basic(bc6h_enc_settings* settings);
 extern "C" void GetProfile_bc6h_slow(bc6h_enc_settings* settings);
 extern "C" void GetProfile_bc6h_veryslow(bc6h_enc_settings* settings);
 
+// profiles for signed BC6H (BC6H_SF16)
+extern "C" void GetProfile_bc6h_signed_veryfast(bc6h_enc_settings* settings);
+extern "C" void GetProfile_bc6h_signed_fast(bc6h_enc_settings* settings);
+extern "C" void GetProfile_bc6h_signed_basic(bc6h_enc_settings* settings);
+extern "C" void GetProfile_bc6h_signed_slow(bc6h_enc_settings* settings);
+extern "C" void GetProfile_bc6h_signed_veryslow(bc6h_enc_settings* settings);
+
 // profiles for ETC
+extern "C" void GetProfile_etc_ultrafast(etc_enc_settings* settings);
+extern "C" void GetProfile_etc_fast(etc_enc_settings* settings);
 extern "C" void GetProfile_etc_slow(etc_enc_settings* settings);
 
 // profiles for ASTC
@@ -99,27 +218,126 @@ extern "C" void GetProfile_astc_fast(astc_enc_settings* settings, int block_widt
 extern "C" void GetProfile_astc_alpha_fast(astc_enc_settings* settings, int block_width, int block_height);
 extern "C" void GetProfile_astc_alpha_slow(astc_enc_settings* settings, int block_width, int block_height);
 
-// helper function to replicate border pixels for the desired block sizes (bpp = 32 or 64)
+// block address callback for FillBlockTable: position of block (xx, yy) in dst, in blocks
+typedef uint32_t (*block_address_func)(int xx, int yy, void* user_data);
+
+// fills an ORDER_TABLE table of blocks_x * blocks_y entries (e.g. a console tiling function)
+extern "C" void FillBlockTable(uint32_t* table, int blocks_x, int blocks_y, block_address_func func, void* user_data);
+
+// helper function to replicate border pixels for the desired block sizes (bpp = 32 or 64),
+// optional since the encoders clamp partial edge blocks themselves
 extern "C" void ReplicateBorders(rgba_surface* dst_slice, const rgba_surface* src_tex, int x, int y, int bpp);
 
 /*
 Notes:
-    - input width and height need to be a multiple of block size
+    - input width and height can be any size: partial blocks at the right/bottom edges are filled by
+      clamping to the last column/row of the source (no ReplicateBorders copy needed)
     - LDR input is 32 bit/pixel (sRGB), HDR is 64 bit/pixel (half float)
-        - for BC4 input is 8bit/pixel (R8), for BC5 input is 16bit/pixel (RG8)
-    - dst buffer must be allocated with enough space for the compressed texture:
-        - 8 bytes/block for BC1/BC4/ETC1,
-        - 16 bytes/block for BC3/BC5/BC6H/BC7/ASTC
-    - the blocks are stored in raster scan order (natural CPU texture layout)
+        - rgba_surface::format and swizzle select other layouts, converted per block in the kernels
+          (UNORM inputs are rounded to 8 bit for LDR, float inputs converted to half for BC6H);
+          the integer kernels only run on native surfaces
+        - SURFACE_PLANAR8/16F read separate channel planes directly, without interleaving them first
+        - for BC4 input is 8bit/pixel (R8), for BC5 input is 16bit/pixel (RG8), signed with the snorm profiles
+        - for EAC R11/RG11 input is R8/RG8 as well, signed for the _signed variants
+    - dst buffer must be allocated with enough space for the compressed texture,
+      ceil(width/block width) * ceil(height/block height) blocks of:
+        - 8 bytes/block for BC1/BC4/ETC1/ETC2/EAC R11,
+        - 16 bytes/block for BC3/BC5/BC6H/BC7/ASTC/ETC2 RGBA8/EAC RG11
+    - the blocks are stored in raster scan order (natural CPU texture layout); rgba_surface::dst_stride
+      sets the dst row pitch so blocks can be written straight into mapped upload/staging buffers
+    - rgba_surface::dst_order writes blocks in Morton, tiled or table order instead (dst_stride is then
+      unused); the block coordinates are relative to src, so split a texture across calls in raster order only
     - use the GetProfile_* functions to select various speed/quality tradeoffs
+    - CompressBlocksBC1/BC3 use the bc1_basic profile, the _settings variants take any bc1_enc_settings
+    - for BC1 with 1-bit alpha set bc1_enc_settings::alpha_threshold (e.g. 128) on any profile;
+      BC3 ignores alpha_threshold and three_color_mode (its color block is always 4-color)
+    - bc1_slow tries 3-color mode without index 3; set three_color_black to also use it as black on opaque
+      textures (off in all profiles, as BC1A readers decode it as transparent)
+    - BC4, BC5 and the bc1_ultrafast profile (bounding box, no refinement) run integer kernels on 16-bit
+      lanes where the instruction set has them; their output is identical on all targets
+        - only native, unswizzled sources (and for BC4/BC5 a width that is a multiple of 4) take the
+          integer kernels, others the float ones: solid blocks encode the same either way, other blocks
+          can differ slightly in endpoint rounding and index selection between the two
+    - CompressBlocksBC4/BC5 match the bc4_fast profile, the _settings variants add endpoint refinement,
+      6-value mode and SNORM output
+    - CompressBlocksBC4BC5_multi reads a 32 bit/pixel RGBA surface once and writes several BC4/BC5
+      outputs from any of its channels (e.g. packed ORM or mask textures); it writes nothing if an output
+      has no dst, channels outside 1..2 or a channel[] outside 0..3
     - the RGB profiles are slightly faster as they ignore the alpha channel
+    - unmodified BC7 profiles run a kernel specialized for that profile, custom settings use the generic one
+    - with a BC7 target_error, mode 6 is tried first; CompressBlocksBC7_stats accumulates into stats (zero it first,
+      not thread-safe: give each thread its own stats)
+    - BC7 rdo_lambda > 0 lets blocks reuse the mode 6 block above (verbatim or its index bits), aimed at
+      better LZ compression of the output; it has no effect with partition_binning or in the stream
+      encoder (each band is a separate call, so its blocks have no block above)
+    - bc7_enc_settings::partition_binning defers the BC7 partition refinement to a second pass over
+      blocks grouped by (mode, partition): same search, intended to improve SIMD utilization on
+      wide targets (not benchmarked yet, off in all profiles)
+    - BC6H settings without slow_mode (veryfast/fast/basic) preselect one 2p and one 1p mode per block, then encode
+      the blocks in bins of the same mode across the surface (uniform precision and packing within a SIMD gang)
+    - blocks with one or two distinct colors skip the endpoint search (BC1/BC3, BC7 single colors via
+      mode 5 in every profile, always exact, two colors via mode 6 when lossless, ETC1 for single color
+      blocks)
+    - the etc_fast/ultrafast profiles prune the ETC1 search (one flip, a window of tables, no level split
+      search on flat halves); all ETC profiles stop early once a block or half is exact
+    - CompressBlocksETC2 writes ETC2 RGB8: the ETC1 search plus planar mode (only tried on blocks whose
+      plane fit beats the ETC1 error) and T/H modes (two color groups split by luma)
+    - CompressBlocksETC2_RGBA writes the EAC alpha block followed by the ETC2 color block; EAC blocks search
+      all 16 modifier tables with the multiplier and base around the block range, then refit the base
 */
 
 extern "C" void CompressBlocksBC1(const rgba_surface* src, uint8_t* dst);
 extern "C" void CompressBlocksBC3(const rgba_surface* src, uint8_t* dst);
+extern "C" void CompressBlocksBC1_settings(const rgba_surface* src, uint8_t* dst, bc1_enc_settings* settings);
+extern "C" void CompressBlocksBC3_settings(const rgba_surface* src, uint8_t* dst, bc1_enc_settings* settings);
 extern "C" void CompressBlocksBC4(const rgba_surface* src, uint8_t* dst);
 extern "C" void CompressBlocksBC5(const rgba_surface* src, uint8_t* dst);
+extern "C" void CompressBlocksBC4_settings(const rgba_surface* src, uint8_t* dst, bc4_enc_settings* settings);
+extern "C" void CompressBlocksBC5_settings(const rgba_surface* src, uint8_t* dst, bc4_enc_settings* settings);
+extern "C" void CompressBlocksBC4BC5_multi(const rgba_surface* src, bc4_output* outputs, int output_count, bc4_enc_settings* settings);
 extern "C" void CompressBlocksBC6H(const rgba_surface* src, uint8_t* dst, bc6h_enc_settings* settings);
 extern "C" void CompressBlocksBC7(const rgba_surface* src, uint8_t* dst, bc7_enc_settings* settings);
+extern "C" void CompressBlocksBC7_stats(const rgba_surface* src, uint8_t* dst, bc7_enc_settings* settings, bc7_enc_stats* stats);
 extern "C" void CompressBlocksETC1(const rgba_surface* src, uint8_t* dst, etc_enc_settings* settings);
+extern "C" void CompressBlocksETC2(const rgba_surface* src, uint8_t* dst, etc_enc_settings* settings);
+extern "C" void CompressBlocksETC2_RGBA(const rgba_surface* src, uint8_t* dst, etc_enc_settings* settings);
+extern "C" void CompressBlocksEAC_R11(const rgba_surface* src, uint8_t* dst);
+extern "C" void CompressBlocksEAC_R11_signed(const rgba_surface* src, uint8_t* dst);
+extern "C" void CompressBlocksEAC_RG11(const rgba_surface* src, uint8_t* dst);
+extern "C" void CompressBlocksEAC_RG11_signed(const rgba_surface* src, uint8_t* dst);
 extern "C" void CompressBlocksASTC(const rgba_surface* src, uint8_t* dst, astc_enc_settings* settings);
+
+/*
+Streaming encoder: source rows are added incrementally, each complete band of block_height rows is
+encoded as soon as it is ready and handed to the output callback one block row at a time, so only a
+band of source rows and one row of blocks are kept in memory.
+    - surface gives width, height, format and swizzle of the whole image (ptr and stride are ignored,
+      dst_stride and dst_order are not used: each block row is tightly packed)
+    - whole bands passed to StreamEncoderAddRows are encoded in place, partial ones are copied first
+    - the last band may be shorter than block_height, its blocks are completed by edge clamping
+    - rows are interleaved pixels: CreateStreamEncoder returns NULL for SURFACE_PLANAR8/16F, and also for
+      non-positive sizes (surface width/height, bytes_per_pixel, block size, bytes_per_block) or missing callbacks
+*/
+
+// encodes one band (e.g. a wrapper calling CompressBlocksBC7 with its settings)
+typedef void (*stream_compress_func)(const rgba_surface* src, uint8_t* dst, void* user_data);
+// receives the blocks of each block row in order, block_row_bytes = blocks per row * bytes_per_block
+typedef void (*stream_output_func)(const uint8_t* blocks, int block_row, int block_row_bytes, void* user_data);
+
+struct stream_encoder_desc
+{
+    rgba_surface surface;
+    int32_t bytes_per_pixel;        // of the source rows
+    int32_t block_width;            // 4, or the ASTC block size
+    int32_t block_height;
+    int32_t bytes_per_block;        // 8 or 16
+    stream_compress_func compress;
+    stream_output_func output;
+    void* user_data;                // passed to compress and output
+};
+
+struct stream_encoder;
+
+extern "C" stream_encoder* CreateStreamEncoder(const stream_encoder_desc* desc);
+extern "C" void StreamEncoderAddRows(stream_encoder* encoder, const uint8_t* rows, int stride, int row_count);
+extern "C" void DestroyStreamEncoder(stream_encoder* encoder);
@@ -21,6 +21,8 @@
 #include <vector>
 #include <limits>
 
+const rgba_surface* checked_order(const rgba_surface* src, rgba_surface* raster); // ispc_texcomp.cpp
+
 void GetProfile_astc_fast(astc_enc_settings* settings, int block_width, int block_height)
 {
     settings->block_width = block_width;
@@ -497,18 +499,19 @@ void astc_encode(const rgba_surface* src, float* block_scores, uint8_t* dst, uin
 
 void CompressBlocksASTC(const rgba_surface* src, uint8_t* dst, astc_enc_settings* settings)
 {
-    assert(src->height % settings->block_height == 0);
-    assert(src->width % settings->block_width == 0);
-    
     assert(settings->block_height <= 8);
     assert(settings->block_width <= 8);
+
+    rgba_surface raster;
+    src = checked_order(src, &raster);
     
-    int tex_width = src->width / settings->block_width;
+    int tex_width = (src->width + settings->block_width - 1) / settings->block_width;
+    int tex_height = (src->height + settings->block_height - 1) / settings->block_height;
     int programCount = ispc::get_programCount();
 
-    std::vector<float> block_scores(tex_width * src->height / settings->block_height);
+    std::vector<float> block_scores(tex_width * tex_height);
 
-    for (int yy = 0; yy < src->height / settings->block_height; yy++)
+    for (int yy = 0; yy < tex_height; yy++)
     for (int xx = 0; xx < tex_width; xx++)
     {
         block_scores[yy * tex_width + xx] = std::numeric_limits<float>::infinity();
@@ -519,7 +522,7 @@ void CompressBlocksASTC(const rgba_surface* src, uint8_t* dst, astc_enc_settings
     std::vector<uint64_t> mode_lists(list_size * mode_list_size);
     std::vector<uint32_t> mode_buffer(programCount * settings->fastSkipTreshold);
 
-    for (int yy = 0; yy < src->height / settings->block_height; yy++)
+    for (int yy = 0; yy < tex_height; yy++)
     for (int _x = 0; _x < (tex_width + programCount - 1) / programCount; _x++)
     {
         int xx = _x * programCount;
@@ -12,11 +12,21 @@ call :build x64   Debug "%~dp0test_astc\test_astc.sln"
 call :build Win32 Release "%~dp0test_astc\test_astc.sln"
 call :build x64   Release "%~dp0test_astc\test_astc.sln"
 
+call :build Win32 Debug "%~dp0test_formats\test_formats.sln"
+call :build x64   Debug "%~dp0test_formats\test_formats.sln"
+call :build Win32 Release "%~dp0test_formats\test_formats.sln"
+call :build x64   Release "%~dp0test_formats\test_formats.sln"
+
 call :build x86 Debug "%~dp0..\ISPC Texture Compressor\ISPC Texture Compressor.sln"
 call :build x64 Debug "%~dp0..\ISPC Texture Compressor\ISPC Texture Compressor.sln"
 call :build x86 Release "%~dp0..\ISPC Texture Compressor\ISPC Texture Compressor.sln"
 call :build x64 Release "%~dp0..\ISPC Texture Compressor\ISPC Texture Compressor.sln"
 
+call :run "%~dp0test_formats\Debug\test_formats.exe"
+call :run "%~dp0test_formats\x64\Debug\test_formats.exe"
+call :run "%~dp0test_formats\Release\test_formats.exe"
+call :run "%~dp0test_formats\x64\Release\test_formats.exe"
+
 echo.
 if "%errorcount%"=="0" (echo PASS) else (echo %errorcount% FAILED)
 exit /b %errorcount%
@@ -28,3 +38,11 @@ exit /b %errorcount%
     msbuild /nologo /verbosity:minimal /p:Platform=%1 /p:Configuration=%2 %3
     if not "%errorlevel%"=="0" set /a errorcount=%errorcount%+1
     exit /b 0
+
+:run
+    echo.
+    echo -------------------------------------------------------------------------------------------------------
+    echo %1
+    %1
+    if not "%errorlevel%"=="0" set /a errorcount=%errorcount%+1
+    exit /b 0
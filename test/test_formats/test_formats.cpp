@@ -0,0 +1,1127 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2016-2019, Intel Corporation
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Round-trip and layout checks: the encoder output is decoded with the reference decoders below
+// (written from the format specifications, independent of the kernels) and compared to the source.
+// Prints the failed checks, returns the number of failures.
+
+#define _CRT_SECURE_NO_WARNINGS
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include "ispc_texcomp.h"
+
+int failures = 0;
+
+void check(bool cond, const char* text, const char* test, int line)
+{
+    if (cond) return;
+    printf("%s (line %d): %s\n", test, line, text);
+    failures++;
+}
+
+#define CHECK(cond) check(cond, #cond, __FUNCTION__, __LINE__)
+
+int clamp(int v, int lo, int hi)
+{
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+uint32_t read_be32(const uint8_t* ptr)
+{
+    return (ptr[0] << 24) | (ptr[1] << 16) | (ptr[2] << 8) | ptr[3];
+}
+
+// deterministic pseudo random bytes, the same on every platform
+uint32_t random_state = 1;
+
+int random_byte()
+{
+    random_state = random_state * 1664525 + 1013904223;
+    return random_state >> 24;
+}
+
+// 8 bit/channel image (RGBA8 by default, R8 or RG8 for the BC4/BC5 and EAC inputs)
+struct image
+{
+    int width;
+    int height;
+    int channels;
+    std::vector<uint8_t> pixels;
+
+    image(int w, int h, int c = 4) : width(w), height(h), channels(c), pixels(w * h * c, 255) {}
+
+    uint8_t* texel(int x, int y) { return &pixels[(y * width + x) * channels]; }
+
+    rgba_surface surface()
+    {
+        rgba_surface src = { pixels.data(), width, height, width * channels };
+        return src;
+    }
+};
+
+double rmse(double sum_sq, int count)
+{
+    return sqrt(sum_sq / count);
+}
+
+///////////////////////////////////////////////////////////
+//                  ETC1/ETC2 RGB decoding
+
+enum etc_mode { ETC_INDIVIDUAL, ETC_DIFFERENTIAL, ETC_T, ETC_H, ETC_PLANAR };
+
+const int etc1_modifiers[8][2] = { { 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 }, { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 } };
+const int etc2_distances[8] = { 3, 6, 11, 16, 23, 32, 41, 64 };
+
+int extend4(int v) { return (v << 4) | v; }
+int extend5(int v) { return (v << 3) | (v >> 2); }
+int extend6(int v) { return (v << 2) | (v >> 4); }
+int extend7(int v) { return (v << 1) | (v >> 6); }
+
+int sign_extend3(int v) { return v >= 4 ? v - 8 : v; }
+
+// 2 bit index of pixel (x, y): MSB in the upper, LSB in the lower half of the low word, column order
+int etc_index(uint32_t lo, int x, int y)
+{
+    int i = x * 4 + y;
+    return (((lo >> (i + 16)) & 1) << 1) | ((lo >> i) & 1);
+}
+
+void etc_paint(int rgb[16][3], uint32_t lo, int paint[4][3])
+{
+    for (int y = 0; y < 4; y++)
+    for (int x = 0; x < 4; x++)
+    for (int p = 0; p < 3; p++)
+    {
+        rgb[y * 4 + x][p] = clamp(paint[etc_index(lo, x, y)][p], 0, 255);
+    }
+}
+
+void etc2_decode_t(int rgb[16][3], uint32_t hi, uint32_t lo)
+{
+    int c1[3] = { extend4((((hi >> 27) & 3) << 2) | ((hi >> 24) & 3)), extend4((hi >> 20) & 15), extend4((hi >> 16) & 15) };
+    int c2[3] = { extend4((hi >> 12) & 15), extend4((hi >> 8) & 15), extend4((hi >> 4) & 15) };
+    int d = etc2_distances[(((hi >> 2) & 3) << 1) | (hi & 1)];
+
+    int paint[4][3];
+    for (int p = 0; p < 3; p++)
+    {
+        paint[0][p] = c1[p];
+        paint[1][p] = c2[p] + d;
+        paint[2][p] = c2[p];
+        paint[3][p] = c2[p] - d;
+    }
+    etc_paint(rgb, lo, paint);
+}
+
+void etc2_decode_h(int rgb[16][3], uint32_t hi, uint32_t lo)
+{
+    int r1 = (hi >> 27) & 15;
+    int g1 = (((hi >> 24) & 7) << 1) | ((hi >> 20) & 1);
+    int b1 = (((hi >> 19) & 1) << 3) | ((hi >> 15) & 7);
+    int r2 = (hi >> 11) & 15;
+    int g2 = (hi >> 7) & 15;
+    int b2 = (hi >> 3) & 15;
+
+    // the lowest distance bit is the order of the base colors
+    int order = ((r1 << 8) | (g1 << 4) | b1) >= ((r2 << 8) | (g2 << 4) | b2) ? 1 : 0;
+    int d = etc2_distances[(((hi >> 2) & 1) << 2) | ((hi & 1) << 1) | order];
+
+    int c1[3] = { extend4(r1), extend4(g1), extend4(b1) };
+    int c2[3] = { extend4(r2), extend4(g2), extend4(b2) };
+
+    int paint[4][3];
+    for (int p = 0; p < 3; p++)
+    {
+        paint[0][p] = c1[p] + d;
+        paint[1][p] = c1[p] - d;
+        paint[2][p] = c2[p] + d;
+        paint[3][p] = c2[p] - d;
+    }
+    etc_paint(rgb, lo, paint);
+}
+
+void etc2_decode_planar(int rgb[16][3], uint32_t hi, uint32_t lo)
+{
+    int o[3] = {
+        extend6((hi >> 25) & 63),
+        extend7((((hi >> 24) & 1) << 6) | ((hi >> 17) & 63)),
+        extend6((((hi >> 16) & 1) << 5) | (((hi >> 11) & 3) << 3) | ((hi >> 7) & 7)) };
+    int h[3] = { extend6((((hi >> 2) & 31) << 1) | (hi & 1)), extend7((lo >> 25) & 127), extend6((lo >> 19) & 63) };
+    int v[3] = { extend6((lo >> 13) & 63), extend7((lo >> 6) & 127), extend6(lo & 63) };
+
+    for (int y = 0; y < 4; y++)
+    for (int x = 0; x < 4; x++)
+    for (int p = 0; p < 3; p++)
+    {
+        rgb[y * 4 + x][p] = clamp((x * (h[p] - o[p]) + y * (v[p] - o[p]) + 4 * o[p] + 2) >> 2, 0, 255);
+    }
+}
+
+// decodes an ETC1 (etc2 = false) or ETC2 RGB block into rgb[y * 4 + x]
+etc_mode decode_etc(int rgb[16][3], const uint8_t* block, bool etc2)
+{
+    uint32_t hi = read_be32(block);
+    uint32_t lo = read_be32(block + 4);
+    bool diff = ((hi >> 1) & 1) != 0;
+    bool flip = (hi & 1) != 0;
+
+    int base[2][3];
+    if (diff)
+    {
+        for (int p = 0; p < 3; p++)
+        {
+            int c = (hi >> (27 - p * 8)) & 31;
+            int c2 = c + sign_extend3((hi >> (24 - p * 8)) & 7);
+
+            if (etc2 && (c2 < 0 || c2 > 31))
+            {
+                // the first overflowing channel selects the mode
+                if (p == 0) etc2_decode_t(rgb, hi, lo);
+                if (p == 1) etc2_decode_h(rgb, hi, lo);
+                if (p == 2) etc2_decode_planar(rgb, hi, lo);
+                return p == 0 ? ETC_T : (p == 1 ? ETC_H : ETC_PLANAR);
+            }
+
+            base[0][p] = extend5(c);
+            base[1][p] = extend5(c2 & 31);
+        }
+    }
+    else
+    {
+        for (int p = 0; p < 3; p++)
+        {
+            base[0][p] = extend4((hi >> (28 - p * 8)) & 15);
+            base[1][p] = extend4((hi >> (24 - p * 8)) & 15);
+        }
+    }
+
+    int tables[2] = { (int)(hi >> 5) & 7, (int)(hi >> 2) & 7 };
+
+    for (int y = 0; y < 4; y++)
+    for (int x = 0; x < 4; x++)
+    {
+        int half = flip ? (y >= 2) : (x >= 2);
+        int q = etc_index(lo, x, y);
+        int modifier = etc1_modifiers[tables[half]][q & 1];
+        if (q & 2) modifier = -modifier;
+
+        for (int p = 0; p < 3; p++)
+            rgb[y * 4 + x][p] = clamp(base[half][p] + modifier, 0, 255);
+    }
+
+    return diff ? ETC_DIFFERENTIAL : ETC_INDIVIDUAL;
+}
+
+// squared RGB error of the decoded block (xx, yy), texels past the image edges are skipped
+int etc_block_error(image* img, int rgb[16][3], int xx, int yy)
+{
+    int err = 0;
+    for (int y = 0; y < 4; y++)
+    for (int x = 0; x < 4; x++)
+    for (int p = 0; p < 3; p++)
+    {
+        if (xx * 4 + x >= img->width || yy * 4 + y >= img->height) continue;
+        int d = rgb[y * 4 + x][p] - img->texel(xx * 4 + x, yy * 4 + y)[p];
+        err += d * d;
+    }
+    return err;
+}
+
+///////////////////////////////////////////////////////////
+//                  BC1
+
+void test_bc1_solid_kernels()
+{
+    bc1_enc_settings ultrafast;
+    GetProfile_bc1_ultrafast(&ultrafast);
+
+    // native RGBA8 takes the integer kernel with bc1_ultrafast, a swizzled source the float one:
+    // solid blocks must not depend on that
+    for (int i = 0; i < 64; i++)
+    {
+        image img(4, 4);
+        int color[3] = { random_byte(), random_byte(), random_byte() };
+        if (i < 8) color[0] = color[1] = color[2] = i * 36;
+
+        for (int y = 0; y < 4; y++)
+        for (int x = 0; x < 4; x++)
+        for (int p = 0; p < 3; p++)
+            img.texel(x, y)[p] = (uint8_t)color[p];
+
+        uint8_t int_block[8];
+        uint8_t float_block[8];
+        rgba_surface src = img.surface();
+        CompressBlocksBC1_settings(&src, int_block, &ultrafast);
+
+        src.swizzle[3] = SWIZZLE_1;
+        CompressBlocksBC1_settings(&src, float_block, &ultrafast);
+
+        CHECK(memcmp(int_block, float_block, 8) == 0);
+    }
+}
+
+///////////////////////////////////////////////////////////
+//                  BC7
+
+int get_bits(const uint8_t* block, int* pos, int bits)
+{
+    int v = 0;
+    for (int i = 0; i < bits; i++, (*pos)++)
+        v |= ((block[*pos / 8] >> (*pos % 8)) & 1) << i;
+    return v;
+}
+
+// decodes a mode 5 block (without rotation) into rgba[y * 4 + x], false for any other mode
+bool decode_bc7_mode5(int rgba[16][4], const uint8_t* block)
+{
+    int pos = 0;
+    if (get_bits(block, &pos, 6) != 0x20) return false;
+    if (get_bits(block, &pos, 2) != 0) return false;
+
+    int ep[2][4];
+    for (int p = 0; p < 3; p++)
+    for (int e = 0; e < 2; e++)
+        ep[e][p] = extend7(get_bits(block, &pos, 7));
+    for (int e = 0; e < 2; e++)
+        ep[e][3] = get_bits(block, &pos, 8);
+
+    static const int weights[4] = { 0, 21, 43, 64 };
+    for (int c = 0; c < 2; c++)
+    for (int k = 0; k < 16; k++)
+    {
+        int q = get_bits(block, &pos, k == 0 ? 1 : 2);
+        for (int p = c * 3; p < (c == 0 ? 3 : 4); p++)
+            rgba[k][p] = ((64 - weights[q]) * ep[0][p] + weights[q] * ep[1][p] + 32) >> 6;
+    }
+    return true;
+}
+
+void test_bc7_solid()
+{
+    typedef void (*bc7_profile_func)(bc7_enc_settings*);
+    const bc7_profile_func profiles[] = { GetProfile_ultrafast, GetProfile_basic, GetProfile_alpha_ultrafast, GetProfile_alpha_slow };
+
+    // single colors are exact in every profile, including the ones that don't search modes 4/5
+    for (int i = 0; i < 4; i++)
+    for (int n = 0; n < 32; n++)
+    {
+        bc7_enc_settings settings;
+        profiles[i](&settings);
+
+        image img(4, 4);
+        int color[4] = { random_byte(), random_byte(), random_byte(), i < 2 ? 255 : random_byte() };
+        if (n < 4) color[0] = color[1] = color[2] = n * 85;
+
+        for (int y = 0; y < 4; y++)
+        for (int x = 0; x < 4; x++)
+        for (int p = 0; p < 4; p++)
+            img.texel(x, y)[p] = (uint8_t)color[p];
+
+        uint8_t block[16];
+        rgba_surface src = img.surface();
+        CompressBlocksBC7(&src, block, &settings);
+
+        int rgba[16][4];
+        CHECK(decode_bc7_mode5(rgba, block));
+        for (int k = 0; k < 16; k++)
+        for (int p = 0; p < 4; p++)
+            CHECK(rgba[k][p] == color[p]);
+    }
+}
+
+///////////////////////////////////////////////////////////
+//                  BC4/BC5 SNORM
+
+// decodes a BC4_SNORM block into values[y * 4 + x], -127..127
+void decode_bc4_snorm(float values[16], const uint8_t* block)
+{
+    int e0 = (int8_t)block[0];
+    int e1 = (int8_t)block[1];
+    if (e0 == -128) e0 = -127;
+    if (e1 == -128) e1 = -127;
+
+    float palette[8];
+    palette[0] = (float)e0;
+    palette[1] = (float)e1;
+    if (e0 > e1)
+    {
+        for (int i = 1; i < 7; i++) palette[i + 1] = ((7 - i) * e0 + i * e1) / 7.0f;
+    }
+    else
+    {
+        for (int i = 1; i < 5; i++) palette[i + 1] = ((5 - i) * e0 + i * e1) / 5.0f;
+        palette[6] = -127;
+        palette[7] = 127;
+    }
+
+    // 3 bit indices, little endian from byte 2, first pixel in the low bits
+    uint64_t bits = 0;
+    for (int i = 0; i < 6; i++) bits |= (uint64_t)block[2 + i] << (i * 8);
+
+    for (int k = 0; k < 16; k++)
+        values[k] = palette[(bits >> (k * 3)) & 7];
+}
+
+// squared error of a BC4_SNORM (channels = 1) or BC5_SNORM (2) texture against the signed source
+double bc4_snorm_texture_error(image* img, const uint8_t* dst, double* max_err)
+{
+    int block_bytes = img->channels * 8;
+    int blocks_x = (img->width + 3) / 4;
+    double sum_sq = 0;
+    *max_err = 0;
+
+    for (int yy = 0; yy < (img->height + 3) / 4; yy++)
+    for (int xx = 0; xx < blocks_x; xx++)
+    for (int c = 0; c < img->channels; c++)
+    {
+        float values[16];
+        decode_bc4_snorm(values, &dst[(yy * blocks_x + xx) * block_bytes + c * 8]);
+
+        for (int y = 0; y < 4; y++)
+        for (int x = 0; x < 4; x++)
+        {
+            if (xx * 4 + x >= img->width || yy * 4 + y >= img->height) continue;
+            int source = clamp((int8_t)img->texel(xx * 4 + x, yy * 4 + y)[c], -127, 127);
+
+            double err = fabs(values[y * 4 + x] - source);
+            if (err > *max_err) *max_err = err;
+            sum_sq += err * err;
+        }
+    }
+
+    return sum_sq;
+}
+
+double bc4_snorm_round_trip(image* img, bc4_enc_settings* settings, double* max_err)
+{
+    std::vector<uint8_t> dst(((img->width + 3) / 4) * ((img->height + 3) / 4) * img->channels * 8);
+
+    rgba_surface src = img->surface();
+    if (img->channels == 1) CompressBlocksBC4_settings(&src, dst.data(), settings);
+    if (img->channels == 2) CompressBlocksBC5_settings(&src, dst.data(), settings);
+
+    return bc4_snorm_texture_error(img, dst.data(), max_err);
+}
+
+void test_bc4_snorm_extremes()
+{
+    bc4_enc_settings settings;
+    GetProfile_bc4_snorm_basic(&settings);
+
+    // -127 and 127 (on either side), -128 reads as -127
+    const int8_t pairs[3][2] = { { -127, 127 }, { -128, 127 }, { -128, -128 } };
+
+    for (int i = 0; i < 3; i++)
+    {
+        image img(4, 4, 1);
+        for (int y = 0; y < 4; y++)
+        for (int x = 0; x < 4; x++)
+            img.texel(x, y)[0] = (uint8_t)pairs[i][(x + y) & 1];
+
+        double max_err;
+        bc4_snorm_round_trip(&img, &settings, &max_err);
+        CHECK(max_err == 0);
+    }
+}
+
+void test_bc4_snorm_profiles()
+{
+    bc4_enc_settings fast;
+    bc4_enc_settings slow;
+    GetProfile_bc4_snorm_fast(&fast);
+    GetProfile_bc4_snorm_slow(&slow);
+
+    for (int channels = 1; channels <= 2; channels++)
+    {
+        // gradient through zero (R), a normal map like mix of slopes and noise (G)
+        image img(20, 14, channels);
+        for (int y = 0; y < img.height; y++)
+        for (int x = 0; x < img.width; x++)
+        {
+            img.texel(x, y)[0] = (uint8_t)(x * 5 + y * 2 - 60);
+            if (channels == 2) img.texel(x, y)[1] = (uint8_t)((x < 10 ? y * 9 - 127 : 112 - y * 3) + random_byte() / 16);
+        }
+
+        int count = img.width * img.height * channels;
+        double max_err;
+        double fast_err = bc4_snorm_round_trip(&img, &fast, &max_err);
+        double slow_err = bc4_snorm_round_trip(&img, &slow, &max_err);
+
+        CHECK(rmse(fast_err, count) < 3);
+        CHECK(slow_err <= fast_err * 1.01 + 1);
+    }
+}
+
+///////////////////////////////////////////////////////////
+//                  ETC1
+
+typedef void (*etc_profile_func)(etc_enc_settings* settings);
+
+const etc_profile_func etc_profiles[3] = { GetProfile_etc_ultrafast, GetProfile_etc_fast, GetProfile_etc_slow };
+
+// encodes img with ETC1, counts the blocks of each mode, returns the total squared error
+int etc1_texture_error(image* img, etc_profile_func profile, int mode_counts[5])
+{
+    etc_enc_settings settings;
+    profile(&settings);
+
+    int blocks_x = (img->width + 3) / 4;
+    int blocks_y = (img->height + 3) / 4;
+    std::vector<uint8_t> dst(blocks_x * blocks_y * 8);
+
+    rgba_surface src = img->surface();
+    CompressBlocksETC1(&src, dst.data(), &settings);
+
+    for (int m = 0; m < 5; m++) mode_counts[m] = 0;
+
+    int err = 0;
+    for (int yy = 0; yy < blocks_y; yy++)
+    for (int xx = 0; xx < blocks_x; xx++)
+    {
+        // as ETC2, an ETC1 block whose differential colors overflow would decode as T/H/planar
+        int rgb[16][3];
+        mode_counts[decode_etc(rgb, &dst[(yy * blocks_x + xx) * 8], true)]++;
+        err += etc_block_error(img, rgb, xx, yy);
+    }
+    return err;
+}
+
+void test_etc1_solid()
+{
+    // exact from a differential base color and the +-8 modifier
+    const uint8_t color[3] = { 90, 173, 49 };
+
+    image img(6, 5);
+    for (int y = 0; y < img.height; y++)
+    for (int x = 0; x < img.width; x++)
+        memcpy(img.texel(x, y), color, 3);
+
+    // the partial edge blocks are filled by clamping, so every block is solid
+    for (etc_profile_func profile : etc_profiles)
+    {
+        int mode_counts[5];
+        CHECK(etc1_texture_error(&img, profile, mode_counts) == 0);
+        CHECK(mode_counts[ETC_INDIVIDUAL] + mode_counts[ETC_DIFFERENTIAL] == 4);
+    }
+}
+
+void test_etc1_individual()
+{
+    // halves 4 bit colors + 2 apart, too far for the differential delta
+    const uint8_t left[3] = { 19, 19, 206 };
+    const uint8_t right[3] = { 206, 36, 2 };
+
+    image img(4, 4);
+    for (int y = 0; y < 4; y++)
+    for (int x = 0; x < 4; x++)
+        memcpy(img.texel(x, y), x < 2 ? left : right, 3);
+
+    int mode_counts[5];
+    CHECK(etc1_texture_error(&img, GetProfile_etc_slow, mode_counts) == 0);
+    CHECK(mode_counts[ETC_INDIVIDUAL] == 1);
+}
+
+void test_etc1_profiles()
+{
+    // smooth gradients, hard edges and noise
+    image img(32, 24);
+    for (int y = 0; y < img.height; y++)
+    for (int x = 0; x < img.width; x++)
+    {
+        uint8_t* texel = img.texel(x, y);
+        texel[0] = (uint8_t)(x * 7 + y);
+        texel[1] = (uint8_t)(((x / 3 + y / 5) & 1) ? 200 : 40);
+        texel[2] = (uint8_t)(y < 12 ? 100 + random_byte() / 4 : 100 + y * 4 - x);
+    }
+
+    int errors[3];
+    for (int i = 0; i < 3; i++)
+    {
+        int mode_counts[5];
+        errors[i] = etc1_texture_error(&img, etc_profiles[i], mode_counts);
+
+        // only the ETC1 modes, with the differential colors in range
+        CHECK(mode_counts[ETC_INDIVIDUAL] + mode_counts[ETC_DIFFERENTIAL] == 8 * 6);
+        CHECK(rmse(errors[i], img.width * img.height * 3) < 20);
+    }
+
+    // the slow profile searches everything the pruned ones do
+    CHECK(errors[2] <= errors[1]);
+    CHECK(errors[2] <= errors[0]);
+}
+
+///////////////////////////////////////////////////////////
+//                  ETC2 RGB
+
+// encodes a single block image with ETC2 etc_slow, returns the decoded mode and error
+etc_mode etc2_round_trip(image* img, int* err)
+{
+    etc_enc_settings settings;
+    GetProfile_etc_slow(&settings);
+
+    rgba_surface src = img->surface();
+    uint8_t block[8];
+    CompressBlocksETC2(&src, block, &settings);
+
+    int rgb[16][3];
+    etc_mode mode = decode_etc(rgb, block, true);
+    *err = etc_block_error(img, rgb, 0, 0);
+    return mode;
+}
+
+void test_etc2_planar()
+{
+    // a plane through 6/7/6 bit corner colors, exact in planar mode, 16 levels per channel for ETC1
+    const int o[3] = { 16, 40, 50 };
+    const int h[3] = { 32, 70, 30 };
+    const int v[3] = { 24, 20, 60 };
+
+    image img(4, 4);
+    for (int p = 0; p < 3; p++)
+    {
+        int eo = p == 1 ? extend7(o[p]) : extend6(o[p]);
+        int eh = p == 1 ? extend7(h[p]) : extend6(h[p]);
+        int ev = p == 1 ? extend7(v[p]) : extend6(v[p]);
+
+        for (int y = 0; y < 4; y++)
+        for (int x = 0; x < 4; x++)
+            img.texel(x, y)[p] = (uint8_t)((x * (eh - eo) + y * (ev - eo) + 4 * eo + 2) >> 2);
+    }
+
+    int err;
+    CHECK(etc2_round_trip(&img, &err) == ETC_PLANAR);
+    CHECK(err == 0);
+}
+
+void test_etc2_t()
+{
+    // checkerboard of two 4 bit colors of different hue: one base color per half can't hold both,
+    // T mode paints them exactly
+    const uint8_t a[3] = { 238, 34, 0 };
+    const uint8_t b[3] = { 0, 102, 204 };
+
+    image img(4, 4);
+    for (int y = 0; y < 4; y++)
+    for (int x = 0; x < 4; x++)
+        memcpy(img.texel(x, y), ((x + y) & 1) ? b : a, 3);
+
+    int err;
+    CHECK(etc2_round_trip(&img, &err) == ETC_T);
+    CHECK(err == 0);
+}
+
+void test_etc2_h()
+{
+    // two 4 bit colors +-16 (distance index 3) in every column: exact in H mode only
+    const int c1[3] = { 34, 51, 68 };
+    const int c2[3] = { 204, 170, 119 };
+    const int d = 16;
+
+    image img(4, 4);
+    for (int y = 0; y < 4; y++)
+    for (int x = 0; x < 4; x++)
+    for (int p = 0; p < 3; p++)
+    {
+        const int colors[4] = { c1[p] + d, c2[p] - d, c1[p] - d, c2[p] + d };
+        img.texel(x, y)[p] = (uint8_t)colors[(x + y) & 3];
+    }
+
+    int err;
+    CHECK(etc2_round_trip(&img, &err) == ETC_H);
+    CHECK(err == 0);
+}
+
+///////////////////////////////////////////////////////////
+//                  EAC
+
+const int eac_modifiers[16][8] =
+{
+    { -3, -6, -9, -15, 2, 5, 8, 14 },
+    { -3, -7, -10, -13, 2, 6, 9, 12 },
+    { -2, -5, -8, -13, 1, 4, 7, 12 },
+    { -2, -4, -6, -13, 1, 3, 5, 12 },
+    { -3, -6, -8, -12, 2, 5, 7, 11 },
+    { -3, -7, -9, -11, 2, 6, 8, 10 },
+    { -4, -7, -8, -11, 3, 6, 7, 10 },
+    { -3, -5, -8, -11, 2, 4, 7, 10 },
+    { -2, -6, -8, -10, 1, 5, 7, 9 },
+    { -2, -5, -8, -10, 1, 4, 7, 9 },
+    { -2, -4, -8, -10, 1, 3, 7, 9 },
+    { -2, -5, -7, -10, 1, 4, 6, 9 },
+    { -3, -4, -7, -10, 2, 3, 6, 9 },
+    { -1, -2, -3, -10, 0, 1, 2, 9 },
+    { -4, -6, -8, -9, 3, 5, 7, 8 },
+    { -3, -5, -7, -9, 2, 4, 6, 8 },
+};
+
+enum eac_format { EAC_ALPHA, EAC_R11, EAC_R11_SIGNED };
+
+// decodes an EAC block into values[y * 4 + x]: 0..255 (alpha), 0..2047 (R11) or -1023..1023 (signed R11)
+void decode_eac(int values[16], const uint8_t* block, eac_format format)
+{
+    uint64_t bits = ((uint64_t)read_be32(block) << 32) | read_be32(block + 4);
+    int base = (int)(bits >> 56);
+    int mult = (int)(bits >> 52) & 15;
+    int table = (int)(bits >> 48) & 15;
+
+    if (format == EAC_R11_SIGNED)
+    {
+        if (base >= 128) base -= 256;
+        if (base == -128) base = -127;
+    }
+
+    // 3 bit indices in column order, first pixel in the top bits
+    for (int i = 0; i < 16; i++)
+    {
+        int modifier = eac_modifiers[table][(bits >> (45 - 3 * i)) & 7];
+        int delta = mult == 0 ? modifier : modifier * mult * 8;
+        int value = 0;
+
+        if (format == EAC_ALPHA) value = clamp(base + modifier * mult, 0, 255);
+        if (format == EAC_R11) value = clamp(base * 8 + 4 + delta, 0, 2047);
+        if (format == EAC_R11_SIGNED) value = clamp(base * 8 + delta, -1023, 1023);
+
+        values[(i % 4) * 4 + i / 4] = value;
+    }
+}
+
+// squared error of one channel of an R11/RG11 (or ETC2 RGBA, alpha) texture against the 8 bit source
+// (signed for EAC_R11_SIGNED), block_bytes apart, the channel's EAC block at offset; the largest
+// single texel error is returned in max_err
+double eac_texture_error(image* img, int channel, const uint8_t* dst, int block_bytes, int offset, eac_format format, double* max_err)
+{
+    double sum_sq = 0;
+    *max_err = 0;
+
+    int blocks_x = (img->width + 3) / 4;
+    for (int yy = 0; yy < (img->height + 3) / 4; yy++)
+    for (int xx = 0; xx < blocks_x; xx++)
+    {
+        int values[16];
+        decode_eac(values, &dst[(yy * blocks_x + xx) * block_bytes + offset], format);
+
+        for (int y = 0; y < 4; y++)
+        for (int x = 0; x < 4; x++)
+        {
+            if (xx * 4 + x >= img->width || yy * 4 + y >= img->height) continue;
+            int source = img->texel(xx * 4 + x, yy * 4 + y)[channel];
+
+            double decoded = values[y * 4 + x];
+            if (format == EAC_R11) decoded = decoded * 255 / 2047;
+            if (format == EAC_R11_SIGNED)
+            {
+                decoded = decoded * 127 / 1023;
+                source = clamp((int8_t)source, -127, 127);
+            }
+
+            double err = fabs(decoded - source);
+            if (err > *max_err) *max_err = err;
+            sum_sq += err * err;
+        }
+    }
+
+    return sum_sq;
+}
+
+// constant, gradient and noise R8 (channels = 1) or RG8 images (signed bytes for is_signed),
+// encoded with R11/RG11 and checked per channel
+void eac_round_trip(int channels, bool is_signed)
+{
+    eac_format format = is_signed ? EAC_R11_SIGNED : EAC_R11;
+    int block_bytes = channels * 8;
+
+    auto compress = [&](image* img, std::vector<uint8_t>* dst)
+    {
+        rgba_surface src = img->surface();
+        dst->assign(((img->width + 3) / 4) * ((img->height + 3) / 4) * block_bytes, 0);
+
+        if (channels == 1 && !is_signed) CompressBlocksEAC_R11(&src, dst->data());
+        if (channels == 1 && is_signed) CompressBlocksEAC_R11_signed(&src, dst->data());
+        if (channels == 2 && !is_signed) CompressBlocksEAC_RG11(&src, dst->data());
+        if (channels == 2 && is_signed) CompressBlocksEAC_RG11_signed(&src, dst->data());
+    };
+
+    std::vector<uint8_t> dst;
+    double max_err;
+
+    // constant blocks, within 8 bit rounding (the multiplier 0 steps reach every 11 bit value)
+    const int constants[] = { 0, 1, 77, 128, 200, 254, 255 };
+    for (int value : constants)
+    {
+        image img(4, 4, channels);
+        for (size_t i = 0; i < img.pixels.size(); i++) img.pixels[i] = (uint8_t)value;
+        compress(&img, &dst);
+
+        for (int c = 0; c < channels; c++)
+        {
+            eac_texture_error(&img, c, dst.data(), block_bytes, c * 8, format, &max_err);
+            CHECK(max_err < 0.5);
+        }
+    }
+
+    // smooth gradient (R) and noise (G, or R of a second image), with partial edge blocks
+    image gradient(18, 14, channels);
+    image noise(18, 14, channels);
+    for (int y = 0; y < gradient.height; y++)
+    for (int x = 0; x < gradient.width; x++)
+    for (int c = 0; c < channels; c++)
+    {
+        int value = 40 + x * 4 + y * 2 + c * 30;
+        gradient.texel(x, y)[c] = (uint8_t)(is_signed ? value - 128 : value);
+        noise.texel(x, y)[c] = (uint8_t)random_byte();
+    }
+
+    int count = gradient.width * gradient.height;
+
+    compress(&gradient, &dst);
+    for (int c = 0; c < channels; c++)
+        CHECK(rmse(eac_texture_error(&gradient, c, dst.data(), block_bytes, c * 8, format, &max_err), count) < 3);
+
+    compress(&noise, &dst);
+    for (int c = 0; c < channels; c++)
+        CHECK(rmse(eac_texture_error(&noise, c, dst.data(), block_bytes, c * 8, format, &max_err), count) < 24);
+}
+
+void test_eac_r11() { eac_round_trip(1, false); }
+void test_eac_r11_signed() { eac_round_trip(1, true); }
+void test_eac_rg11() { eac_round_trip(2, false); }
+void test_eac_rg11_signed() { eac_round_trip(2, true); }
+
+void test_etc2_rgba_alpha()
+{
+    etc_enc_settings settings;
+    GetProfile_etc_fast(&settings);
+
+    // random colors, alpha: opaque and transparent rows, then a gradient
+    image img(16, 12);
+    for (int y = 0; y < img.height; y++)
+    for (int x = 0; x < img.width; x++)
+    {
+        uint8_t* texel = img.texel(x, y);
+        for (int p = 0; p < 3; p++) texel[p] = (uint8_t)random_byte();
+        texel[3] = (uint8_t)(y < 4 ? (x < 8 ? 255 : 0) : 60 + x * 5 + y * 3);
+    }
+
+    rgba_surface src = img.surface();
+    std::vector<uint8_t> dst(4 * 3 * 16);
+    CompressBlocksETC2_RGBA(&src, dst.data(), &settings);
+
+    // the alpha block comes first
+    image edges(16, 4);
+    memcpy(edges.pixels.data(), img.pixels.data(), edges.pixels.size());
+    double max_err;
+    eac_texture_error(&edges, 3, dst.data(), 16, 0, EAC_ALPHA, &max_err);
+    CHECK(max_err == 0);
+
+    double sum_sq = eac_texture_error(&img, 3, dst.data(), 16, 0, EAC_ALPHA, &max_err);
+    CHECK(rmse(sum_sq, img.width * img.height) < 3);
+}
+
+///////////////////////////////////////////////////////////
+//                  block orders
+
+typedef void (*compress_func)(const rgba_surface* src, uint8_t* dst);
+
+struct layout_format
+{
+    compress_func compress;
+    int channels;
+    int block_bytes;
+    int width;              // 5 blocks, a multiple of 4 where the integer kernel needs it
+};
+
+void compress_bc1_ultrafast(const rgba_surface* src, uint8_t* dst)
+{
+    bc1_enc_settings settings;
+    GetProfile_bc1_ultrafast(&settings);
+    CompressBlocksBC1_settings(src, dst, &settings);
+}
+
+// the float kernels (BC1, BC3) and the integer kernels (bc1_ultrafast, BC4 on whole block columns)
+// have their own store paths
+const layout_format layout_formats[4] =
+{
+    { CompressBlocksBC1, 4, 8, 18 },
+    { CompressBlocksBC3, 4, 16, 18 },
+    { compress_bc1_ultrafast, 4, 8, 18 },
+    { CompressBlocksBC4, 1, 8, 20 },
+};
+
+const int layout_blocks_x = 5;
+const int layout_blocks_y = 3;
+
+uint32_t morton_index(int xx, int yy)
+{
+    uint32_t index = 0;
+    for (int bit = 0; bit < 16; bit++)
+        index |= (((xx >> bit) & 1) << (2 * bit)) | (((yy >> bit) & 1) << (2 * bit + 1));
+    return index;
+}
+
+uint32_t reversed_block(int xx, int yy, void* user_data)
+{
+    return (layout_blocks_y - 1 - yy) * layout_blocks_x + layout_blocks_x - 1 - xx;
+}
+
+// encodes a random image of 5x3 blocks (partial blocks included) in raster order and with the dst_order fields of
+// order into a buffer of slots.size() blocks; slots[i] is the raster block expected in block i, or -1 for
+// blocks that must stay untouched
+bool check_order(const layout_format& format, const rgba_surface& order, const std::vector<int>& slots)
+{
+    image img(format.width, 11, format.channels);
+    for (size_t i = 0; i < img.pixels.size(); i++) img.pixels[i] = (uint8_t)random_byte();
+
+    std::vector<uint8_t> raster(layout_blocks_x * layout_blocks_y * format.block_bytes);
+    rgba_surface src = img.surface();
+    format.compress(&src, raster.data());
+
+    std::vector<uint8_t> dst(slots.size() * format.block_bytes, 0xCD);
+    src.dst_order = order.dst_order;
+    src.dst_tile_width = order.dst_tile_width;
+    src.dst_tile_height = order.dst_tile_height;
+    src.dst_blocks = order.dst_blocks;
+    format.compress(&src, dst.data());
+
+    for (size_t i = 0; i < slots.size(); i++)
+    for (int b = 0; b < format.block_bytes; b++)
+    {
+        uint8_t expected = slots[i] < 0 ? 0xCD : raster[slots[i] * format.block_bytes + b];
+        if (dst[i * format.block_bytes + b] != expected) return false;
+    }
+    return true;
+}
+
+void test_morton_order()
+{
+    // 5x3 blocks, sized for the enclosing 8x8 square
+    std::vector<int> slots(64, -1);
+    for (int yy = 0; yy < layout_blocks_y; yy++)
+    for (int xx = 0; xx < layout_blocks_x; xx++)
+        slots[morton_index(xx, yy)] = yy * layout_blocks_x + xx;
+
+    rgba_surface order = {};
+    order.dst_order = ORDER_MORTON;
+    for (const layout_format& format : layout_formats)
+        CHECK(check_order(format, order, slots));
+}
+
+void test_tiled_order()
+{
+    const int tile_sizes[3][2] = { { 2, 2 }, { 3, 2 }, { 1, 4 } };
+
+    for (int t = 0; t < 3; t++)
+    {
+        int tw = tile_sizes[t][0];
+        int th = tile_sizes[t][1];
+        int tiles_x = (layout_blocks_x + tw - 1) / tw;
+        int tiles_y = (layout_blocks_y + th - 1) / th;
+
+        // whole tiles: the blocks past the right/bottom edge of the edge tiles stay untouched
+        std::vector<int> slots(tiles_x * tiles_y * tw * th, -1);
+        for (int yy = 0; yy < layout_blocks_y; yy++)
+        for (int xx = 0; xx < layout_blocks_x; xx++)
+        {
+            int tile = (yy / th) * tiles_x + xx / tw;
+            slots[tile * tw * th + (yy % th) * tw + xx % tw] = yy * layout_blocks_x + xx;
+        }
+
+        rgba_surface order = {};
+        order.dst_order = ORDER_TILED;
+        order.dst_tile_width = tw;
+        order.dst_tile_height = th;
+        for (const layout_format& format : layout_formats)
+            CHECK(check_order(format, order, slots));
+    }
+}
+
+void test_table_order()
+{
+    std::vector<uint32_t> table(layout_blocks_x * layout_blocks_y);
+    FillBlockTable(table.data(), layout_blocks_x, layout_blocks_y, reversed_block, nullptr);
+
+    std::vector<int> slots(table.size());
+    for (size_t i = 0; i < table.size(); i++) slots[table[i]] = (int)i;
+
+    rgba_surface order = {};
+    order.dst_order = ORDER_TABLE;
+    order.dst_blocks = table.data();
+    for (const layout_format& format : layout_formats)
+        CHECK(check_order(format, order, slots));
+}
+
+void test_invalid_order()
+{
+    std::vector<int> slots(layout_blocks_x * layout_blocks_y);
+    for (size_t i = 0; i < slots.size(); i++) slots[i] = (int)i;
+
+    // a tile size below 1, no table and an unknown order all write raster order
+    rgba_surface orders[4] = {};
+    orders[0].dst_order = ORDER_TILED;
+    orders[1].dst_order = ORDER_TILED;
+    orders[1].dst_tile_width = 2;
+    orders[2].dst_order = ORDER_TABLE;
+    orders[3].dst_order = 17;
+
+    for (const rgba_surface& order : orders)
+    for (const layout_format& format : layout_formats)
+        CHECK(check_order(format, order, slots));
+}
+
+///////////////////////////////////////////////////////////
+//                  stream encoder
+
+struct stream_output
+{
+    std::vector<uint8_t> blocks;
+    int block_rows;
+    bool in_order;
+};
+
+void stream_compress_bc1(const rgba_surface* src, uint8_t* dst, void* user_data)
+{
+    CompressBlocksBC1(src, dst);
+}
+
+void stream_store(const uint8_t* blocks, int block_row, int block_row_bytes, void* user_data)
+{
+    stream_output* output = (stream_output*)user_data;
+    if (block_row != output->block_rows) output->in_order = false;
+
+    output->blocks.resize((block_row + 1) * block_row_bytes);
+    memcpy(&output->blocks[block_row * block_row_bytes], blocks, block_row_bytes);
+    output->block_rows++;
+}
+
+void test_stream_encoder()
+{
+    // 30 rows: 7 whole bands and a 2 row one
+    image img(40, 30);
+    for (size_t i = 0; i < img.pixels.size(); i++) img.pixels[i] = (uint8_t)random_byte();
+
+    std::vector<uint8_t> expected(10 * 8 * 8);
+    rgba_surface src = img.surface();
+    CompressBlocksBC1(&src, expected.data());
+
+    stream_output output;
+    output.block_rows = 0;
+    output.in_order = true;
+
+    stream_encoder_desc desc = {};
+    desc.surface = src;
+    desc.bytes_per_pixel = 4;
+    desc.block_width = 4;
+    desc.block_height = 4;
+    desc.bytes_per_block = 8;
+    desc.compress = stream_compress_bc1;
+    desc.output = stream_store;
+    desc.user_data = &output;
+
+    stream_encoder* encoder = CreateStreamEncoder(&desc);
+    CHECK(encoder != nullptr);
+    if (!encoder) return;
+
+    // chunks across band boundaries, partial bands are buffered, whole ones encoded in place
+    const int chunks[5] = { 1, 2, 3, 5, 7 };
+    for (int y = 0, i = 0; y < img.height; i++)
+    {
+        int rows = chunks[i % 5] < img.height - y ? chunks[i % 5] : img.height - y;
+        StreamEncoderAddRows(encoder, img.texel(0, y), img.width * 4, rows);
+        y += rows;
+    }
+    DestroyStreamEncoder(encoder);
+
+    CHECK(output.block_rows == 8);
+    CHECK(output.in_order);
+    CHECK(output.blocks == expected);
+}
+
+void test_stream_encoder_planar()
+{
+    // rows are interleaved pixels, planar surfaces can't be streamed
+    stream_encoder_desc desc = {};
+    desc.surface.width = 16;
+    desc.surface.height = 16;
+    desc.surface.format = SURFACE_PLANAR8;
+    desc.bytes_per_pixel = 4;
+    desc.block_width = 4;
+    desc.block_height = 4;
+    desc.bytes_per_block = 8;
+    desc.compress = stream_compress_bc1;
+    desc.output = stream_store;
+
+    CHECK(CreateStreamEncoder(&desc) == nullptr);
+}
+
+void test_stream_encoder_invalid()
+{
+    stream_encoder_desc valid = {};
+    valid.surface.width = 16;
+    valid.surface.height = 16;
+    valid.bytes_per_pixel = 4;
+    valid.block_width = 4;
+    valid.block_height = 4;
+    valid.bytes_per_block = 8;
+    valid.compress = stream_compress_bc1;
+    valid.output = stream_store;
+
+    stream_encoder* encoder = CreateStreamEncoder(&valid);
+    CHECK(encoder != nullptr);
+    if (encoder) DestroyStreamEncoder(encoder);
+
+    // each of these would loop forever, throw or call through NULL on the first band
+    stream_encoder_desc descs[7] = { valid, valid, valid, valid, valid, valid, valid };
+    descs[0].block_height = 0;
+    descs[1].block_width = -4;
+    descs[2].bytes_per_block = 0;
+    descs[3].bytes_per_pixel = 0;
+    descs[4].surface.height = -1;
+    descs[5].compress = nullptr;
+    descs[6].output = nullptr;
+
+    for (const stream_encoder_desc& desc : descs)
+        CHECK(CreateStreamEncoder(&desc) == nullptr);
+}
+
+int main()
+{
+    test_bc1_solid_kernels();
+    test_bc7_solid();
+    test_bc4_snorm_extremes();
+    test_bc4_snorm_profiles();
+    test_etc1_solid();
+    test_etc1_individual();
+    test_etc1_profiles();
+    test_etc2_planar();
+    test_etc2_t();
+    test_etc2_h();
+    test_eac_r11();
+    test_eac_r11_signed();
+    test_eac_rg11();
+    test_eac_rg11_signed();
+    test_etc2_rgba_alpha();
+    test_morton_order();
+    test_tiled_order();
+    test_table_order();
+    test_invalid_order();
+    test_stream_encoder();
+    test_stream_encoder_planar();
+    test_stream_encoder_invalid();
+
+    if (failures == 0) printf("PASS\n");
+    else printf("%d checks FAILED\n", failures);
+    return failures;
+}